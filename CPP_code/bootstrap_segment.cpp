@@ -108,33 +108,16 @@ bool BootstrapSegment::is_alive() const
            first_operation->parents_meet_urgency_criteria();
 }
 
-bool BootstrapSegment::relies_on_bootstrap_pair(const OperationPtr &parent, const OperationPtr &child) const
+BootstrapPairVector BootstrapSegment::get_currently_satisfying_pairs() const
 {
-    for (size_t i = 0; i < segment.size() - 1; i++)
-    {
-        auto other_parent = segment[i];
-        auto other_child = segment[i + 1];
-        if (other_parent != parent || other_child != child)
-        {
-            if (other_parent->bootstrap_children.contains(other_child))
-            {
-                return false;
-            }
-        }
-    }
-    return true;
-}
-
-BootstrapPairSet BootstrapSegment::get_currently_satisfying_pairs() const
-{
-    BootstrapPairSet currently_satisfying_pairs;
+    BootstrapPairVector currently_satisfying_pairs;
     for (size_t i = 0; i < segment.size() - 1; i++)
     {
         auto parent = segment[i];
         auto child = segment[i + 1];
         if (parent->bootstrap_children.contains(child))
         {
-            currently_satisfying_pairs.insert({parent, child});
+            currently_satisfying_pairs.push_back({parent, child});
         }
     }
     return currently_satisfying_pairs;
@@ -144,3 +127,16 @@ void BootstrapSegment::set_last_mul(const OperationPtr &op)
 {
     last_mul = op;
 }
+
+// Points the segment at the matching operations of a copied program.
+void BootstrapSegment::remap_operations(const std::function<OperationPtr(const OperationPtr &)> &get_copy)
+{
+    for (auto &operation : segment)
+    {
+        operation = get_copy(operation);
+    }
+    if (last_mul != nullptr)
+    {
+        last_mul = get_copy(last_mul);
+    }
+}
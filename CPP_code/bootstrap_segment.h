@@ -17,10 +17,14 @@ struct BootstrapPair
         }
         return parent->id < other.parent->id;
     }
+
+    bool operator==(const BootstrapPair &other) const
+    {
+        return parent == other.parent && child == other.child;
+    }
 };
 
-using BootstrapPairSet = std::set<BootstrapPair>;
-using BootstrapPairIndexesMap = std::map<BootstrapPair, std::unordered_set<size_t>>;
+using BootstrapPairVector = std::vector<BootstrapPair>;
 
 class BootstrapSegment
 {
@@ -45,10 +49,10 @@ public:
     void update_satisfied_status(const BootstrapMode);
     bool is_satisfied() const;
     bool is_alive() const;
-    bool relies_on_bootstrap_pair(const OperationPtr &, const OperationPtr &) const;
-    BootstrapPairSet get_currently_satisfying_pairs() const;
+    BootstrapPairVector get_currently_satisfying_pairs() const;
 
     void set_last_mul(const OperationPtr &);
+    void remap_operations(const std::function<OperationPtr(const OperationPtr &)> &);
 
 private:
     void update_satisfied_status_in_complete_mode();
@@ -7,10 +7,81 @@ BootstrapSetSelector::BootstrapSetSelector(int argc, char **argv)
     Program::ConstructorInput in;
     in.dag_filename = options.dag_filename;
     in.segments_filename = options.segments_filename;
+    in.latency_filename = options.latency_filename;
 
     program = Program(in);
 
     program.set_boot_mode(BootstrapMode::COMPLETE);
+
+    if (!options.feedback_filename.empty())
+    {
+        initialize_scheduled_slacks();
+    }
+}
+
+// How long the result of each operation could wait in the fed back
+// schedule before it holds anything up, plus the share of the cores that
+// would be idle while it is bootstrapped.
+void BootstrapSetSelector::initialize_scheduled_slacks()
+{
+    Program::ConstructorInput in;
+    in.dag_filename = options.dag_filename;
+    in.bootstrap_filename = options.feedback_filename;
+    in.latency_filename = options.latency_filename;
+    auto scheduled_program = Program(in);
+
+    std::map<int, std::vector<std::pair<int, int>>> busy_intervals;
+    int makespan = 0;
+    for (const auto &operation : scheduled_program)
+    {
+        auto finish_time = operation->start_time + scheduled_program.get_latency_of(operation);
+        busy_intervals[operation->core_num].emplace_back(operation->start_time, finish_time);
+        makespan = std::max(makespan, finish_time);
+        if (operation->is_bootstrapped())
+        {
+            auto bootstrap_latency = scheduled_program.get_bootstrap_latency_of(operation);
+            auto core_num = operation->bootstrap_core_num > 0 ? operation->bootstrap_core_num : operation->core_num;
+            busy_intervals[core_num].emplace_back(operation->bootstrap_start_time,
+                                                  operation->bootstrap_start_time + bootstrap_latency);
+            makespan = std::max(makespan, operation->bootstrap_start_time + bootstrap_latency);
+        }
+    }
+
+    scheduled_slacks.assign(program.size() + 1, 0);
+    for (const auto &operation : scheduled_program)
+    {
+        auto finish_time = operation->start_time + scheduled_program.get_latency_of(operation);
+        auto bootstrap_latency = scheduled_program.get_bootstrap_latency_of(operation);
+        auto first_use_time = makespan;
+        for (const auto &child : operation->child_ptrs)
+        {
+            first_use_time = std::min(first_use_time, child->start_time);
+        }
+
+        int window_end = finish_time + bootstrap_latency;
+        int idle_core_cycles = 0;
+        for (const auto &[core_num, intervals] : busy_intervals)
+        {
+            int busy_cycles = 0;
+            for (const auto &[start_time, end_time] : intervals)
+            {
+                busy_cycles += std::max(0, std::min(end_time, window_end) - std::max(start_time, finish_time));
+            }
+            idle_core_cycles += bootstrap_latency - busy_cycles;
+        }
+
+        scheduled_slacks[operation->id] = std::max(0, first_use_time - finish_time) +
+                                          idle_core_cycles / int(busy_intervals.size());
+    }
+}
+
+int BootstrapSetSelector::get_slack(const OperationPtr &operation) const
+{
+    if (scheduled_slacks.empty())
+    {
+        return operation->get_slack();
+    }
+    return scheduled_slacks[operation->id];
 }
 
 void BootstrapSetSelector::choose_and_output_bootstrap_sets()
@@ -20,11 +91,25 @@ void BootstrapSetSelector::choose_and_output_bootstrap_sets()
         program.reset_bootstrap_set();
         print_options();
 
+        weights = {double(options.segments_weight[set_index]),
+                   double(options.slack_weight[set_index]),
+                   double(options.urgency_weight[set_index])};
+
         std::function<void()> choose_operations_func = [this]()
         { choose_operations_to_bootstrap(); };
 
         utl::perform_func_and_print_execution_time(choose_operations_func, "Choosing operations to bootstrap");
 
+        if (options.time_budget.is_limited())
+        {
+            auto set_budget = utl::TimeBudget(options.time_budget.remaining_seconds() / (num_sets - set_index));
+
+            std::function<void()> improve_func = [this, &set_budget]()
+            { improve_bootstrap_set(set_budget); };
+
+            utl::perform_func_and_print_execution_time(improve_func, "Improving bootstrap set");
+        }
+
         std::function<void()> write_file_func = [this]()
         {
             auto file_writer = FileWriter(std::ref(program));
@@ -44,7 +129,7 @@ void BootstrapSetSelector::choose_and_output_bootstrap_sets()
     }
 }
 
-void BootstrapSetSelector::choose_operations_to_bootstrap()
+bool BootstrapSetSelector::choose_operations_to_bootstrap(const utl::TimeBudget &time_budget)
 {
     auto count = 0;
     program.initialize_unsatisfied_segment_indexes();
@@ -53,24 +138,95 @@ void BootstrapSetSelector::choose_operations_to_bootstrap()
     program.initialize_operation_to_segments_map();
     while (program.has_unsatisfied_bootstrap_segments())
     {
+        if (time_budget.expired())
+        {
+            return false;
+        }
         max_num_segments = program.get_maximum_num_segments();
-        if (options.slack_weight[set_index] != 0)
+        if (weights.slack != 0 && !scheduled_slacks.empty())
+        {
+            max_slack = std::ranges::max(scheduled_slacks);
+        }
+        else if (weights.slack != 0)
         {
             program.update_slack_for_every_operation();
             max_slack = program.get_maximum_slack();
         }
-        if (options.urgency_weight[set_index] != 0)
+        if (weights.urgency != 0)
         {
             program.update_all_bootstrap_urgencies();
         }
         auto chosen_op = choose_operation_to_bootstrap_based_on_score();
 
         auto newly_satisfied_segments = program.update_unsatisfied_segments_and_num_segments_for_every_operation();
-        if (options.urgency_weight[set_index] != 0)
+        if (weights.urgency != 0)
         {
             program.update_alive_segments(chosen_op, newly_satisfied_segments);
         }
     }
+    return true;
+}
+
+// Hill climbs in weight space from the given weights. Each trial reruns the
+// selection with perturbed weights, and a trial that does not finish before
+// the budget expires is discarded.
+void BootstrapSetSelector::improve_bootstrap_set(const utl::TimeBudget &set_budget)
+{
+    auto quality_log = utl::QualityLog(set_budget);
+
+    program.remove_redundant_bootstrapped_operations();
+    auto best_set = get_bootstrapped_operations();
+    auto best_weights = weights;
+    quality_log.record(best_set.size());
+
+    std::minstd_rand rand_gen;
+    auto max_weight = std::max({1.0, weights.segments, weights.slack, weights.urgency});
+    std::normal_distribution<double> noise(0, max_weight / 4);
+
+    while (!set_budget.expired())
+    {
+        weights.segments = std::max(0.0, best_weights.segments + noise(rand_gen));
+        weights.slack = std::max(0.0, best_weights.slack + noise(rand_gen));
+        weights.urgency = std::max(0.0, best_weights.urgency + noise(rand_gen));
+
+        program.reset_bootstrap_set();
+        if (!choose_operations_to_bootstrap(set_budget))
+        {
+            break;
+        }
+        program.remove_redundant_bootstrapped_operations();
+
+        if (program.get_num_bootstrapped_operations() < best_set.size())
+        {
+            best_set = get_bootstrapped_operations();
+            best_weights = weights;
+            quality_log.record(best_set.size());
+        }
+    }
+
+    weights = best_weights;
+    program.reset_bootstrap_set();
+    for (const auto &operation : best_set)
+    {
+        operation->bootstrap_children = operation->child_ptrs;
+    }
+
+    std::cout << "Best weights: " << weights.segments << "," << weights.slack << "," << weights.urgency << std::endl;
+    std::cout << "Number of bootstrapped operations: " << best_set.size() << std::endl;
+    quality_log.write_to_file(options.output_filenames[set_index] + "_quality.csv");
+}
+
+OpVector BootstrapSetSelector::get_bootstrapped_operations() const
+{
+    OpVector bootstrapped_operations;
+    for (const auto &operation : program)
+    {
+        if (operation->is_bootstrapped())
+        {
+            bootstrapped_operations.push_back(operation);
+        }
+    }
+    return bootstrapped_operations;
 }
 
 OperationPtr BootstrapSetSelector::choose_operation_to_bootstrap_based_on_score()
@@ -112,13 +268,13 @@ double BootstrapSetSelector::get_score(const OperationPtr &operation) const
     }
     else
     {
-        normalized_slack = ((double)operation->get_slack()) / max_slack;
+        normalized_slack = ((double)get_slack(operation)) / max_slack;
     }
 
     double score =
-        options.segments_weight[set_index] * normalized_num_segments +
-        options.slack_weight[set_index] * normalized_slack +
-        options.urgency_weight[set_index] * operation->bootstrap_urgency;
+        weights.segments * normalized_num_segments +
+        weights.slack * normalized_slack +
+        weights.urgency * operation->bootstrap_urgency;
 
     return std::max(score, 0.0);
 }
@@ -148,6 +304,11 @@ void BootstrapSetSelector::parse_args(int argc, char **argv)
     options.segments_weight = utl::get_list_arg(options_string, "-s", "--segments-weight", help_info, num_sets, 0, stoi_function);
     options.slack_weight = utl::get_list_arg(options_string, "-r", "--slack-weight", help_info, num_sets, 0, stoi_function);
     options.urgency_weight = utl::get_list_arg(options_string, "-u", "--urgency-weight", help_info, num_sets, 0, stoi_function);
+
+    options.latency_filename = utl::get_arg(options_string, "-l", "--latency-file", help_info);
+    options.feedback_filename = utl::get_arg(options_string, "-f", "--schedule-feedback", help_info);
+
+    options.time_budget = utl::get_time_budget_arg(options_string, help_info);
 }
 
 std::string BootstrapSetSelector::get_log_filename() const
@@ -164,6 +325,7 @@ void BootstrapSetSelector::print_options() const
     std::cout << "segments_weight: " << options.segments_weight[set_index] << std::endl;
     std::cout << "slack_weight: " << options.slack_weight[set_index] << std::endl;
     std::cout << "urgency_weight: " << options.urgency_weight[set_index] << std::endl;
+    std::cout << "feedback_filename: " << options.feedback_filename << std::endl;
 }
 
 int main(int argc, char **argv)
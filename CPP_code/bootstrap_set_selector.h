@@ -29,6 +29,8 @@ Usage: ./bootstrap_set_selector <dag_file>
                                 [-s <int_1>[,<int_2>,...,<int_n>]]
                                 [-r <int_1>[,<int_2>,...,<int_n>]]
                                 [-u <int_1>[,<int_2>,...,<int_n>]]
+                                [-f <file>]
+                                [-T <float>]
 
 Arguments:
   <dag_file>
@@ -40,6 +42,9 @@ Arguments:
   -l <file>, --latency-file=<file>
     A file describing the latencies of FHE operations on the target
     hardware. The default values can be found in program.h.
+    Lines of the form <type>,<levels>,<latency> give the latency of an
+    operation whose inputs have <levels> levels left. The largest listed
+    level is the level of fresh and bootstrapped ciphertexts.
   Weights:
     The following options apply weights to certain attributes that are
     used in choosing operations to bootstrap. All default to 0.
@@ -48,11 +53,25 @@ Arguments:
         bootstrap segments containing the operation.
       -r <int>, --slack-weight=<int>
         This attribute correlates to the difference between the
-        operation's latest and earliest starting times.
+        operation's latest and earliest starting times, or to its
+        scheduled slack when -f is given.
       -u <int>, --urgency-weight=<int>
         This attribute correlates to the current bootstrap
         urgency level of the operation.
-        
+  -f <file>, --schedule-feedback=<file>
+    A .lgr file written by list_scheduler.out for an earlier bootstrap
+    set of this graph. The slack of an operation is then taken from
+    that schedule instead of the unscheduled graph: the cycles between
+    its finish and the start of its first consumer, plus the idle core
+    cycles in the bootstrap latency after its finish, divided by the
+    number of cores. See scripts/select_and_schedule_with_feedback.sh.
+  -T <float>, --time-budget=<float>
+    A wall-clock budget in seconds, shared evenly between the sets
+    of a batch. When given, redundant bootstraps are removed from
+    each set and the weights are tuned by local search until the
+    budget expires, keeping the set with the fewest bootstraps. The
+    set size over time is written to <output_file>_quality.csv.
+
 Batching:
   Notice that multiple output files may be specified as a comma-
   separated list. This is so multiple bootstrap sets can be created
@@ -69,17 +88,35 @@ Batching:
     std::vector<int> segments_weight;
     std::vector<int> slack_weight;
     std::vector<int> urgency_weight;
+    std::string latency_filename;
+    std::string feedback_filename;
+    utl::TimeBudget time_budget;
   } options;
 
+  struct Weights
+  {
+    double segments;
+    double slack;
+    double urgency;
+  } weights;
+
   int max_num_segments;
-  int max_slack;
+  int max_slack = 0;
+
+  // Indexed by operation id. Empty unless a schedule is fed back.
+  std::vector<int> scheduled_slacks;
 
   size_t num_sets;
   size_t set_index = 0;
 
   Program program;
 
-  void choose_operations_to_bootstrap();
+  bool choose_operations_to_bootstrap(const utl::TimeBudget & = utl::TimeBudget());
+  void improve_bootstrap_set(const utl::TimeBudget &);
+  OpVector get_bootstrapped_operations() const;
+
+  void initialize_scheduled_slacks();
+  int get_slack(const OperationPtr &) const;
 
   OperationPtr choose_operation_to_bootstrap_based_on_score();
   double get_score(const OperationPtr &) const;
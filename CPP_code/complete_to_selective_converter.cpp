@@ -3,14 +3,34 @@
 #include "program.h"
 #include "file_writer.h"
 
+const std::string help_info = R"(
+Usage: ./complete_to_selective_converter.out <input_dag_file>
+                                             <segments_file>
+                                             <input_lgr_file>
+                                             <output_lgr_file>
+                                             [<options>]
+
+Options:
+  -T <float>, --time-budget=<float>
+    A wall-clock budget in seconds. When given, other removal orders
+    are tried until the budget expires and the order removing the most
+    pairs is kept. The number of remaining pairs over time is written
+    to <output_lgr_file>_quality.csv.)";
+
 int main(int argc, char *argv[])
 {
-    if (argc != 5)
+    const int minimum_arguments = 5;
+
+    if (argc < minimum_arguments)
     {
-        std::cout << "Usage: " << argv[0] << " <input_dag_file> <segments_file> <input_lgr_file> <output_lgr_file>" << std::endl;
+        std::cout << help_info << std::endl;
         return 1;
     }
 
+    std::string options_string = utl::make_options_string(argc, argv, minimum_arguments);
+    auto time_budget = utl::get_time_budget_arg(options_string, help_info);
+    auto quality_log = utl::QualityLog(time_budget);
+
     Program::ConstructorInput in;
     in.dag_filename = argv[1];
     in.segments_filename = argv[2];
@@ -24,10 +44,10 @@ int main(int argc, char *argv[])
     size_t num_pairs_removed;
     size_t total_num_pairs;
 
-    std::function<void()> main_func = [&program, &output_lgr_filename, &num_pairs_removed, &total_num_pairs]()
+    std::function<void()> main_func = [&]()
     {
-        std::function<void()> conversion_func = [&program, &num_pairs_removed, &total_num_pairs]()
-        { program.remove_unnecessary_bootstrap_pairs(num_pairs_removed, total_num_pairs); };
+        std::function<void()> conversion_func = [&]()
+        { program.remove_unnecessary_bootstrap_pairs(num_pairs_removed, total_num_pairs, time_budget, quality_log); };
 
         utl::perform_func_and_print_execution_time(
             conversion_func, "Removing unnecessary bootstrap pairs");
@@ -48,5 +68,10 @@ int main(int argc, char *argv[])
     log_file << num_remaining_pairs << std::endl;
     // log_file << total_num_pairs << std::endl;
 
+    if (time_budget.is_limited())
+    {
+        quality_log.write_to_file(output_lgr_filename + "_quality.csv");
+    }
+
     return 0;
 }
\ No newline at end of file
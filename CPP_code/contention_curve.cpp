@@ -0,0 +1,80 @@
+#include "contention_curve.h"
+
+ContentionCurve::ContentionCurve(const std::string &filename)
+{
+    parse_curve_file(filename);
+}
+
+void ContentionCurve::parse_curve_file(const std::string &filename)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        std::cout << "Could not open contention file " << filename << std::endl;
+        exit(1);
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        utl::trim(line);
+        if (line.empty())
+        {
+            continue;
+        }
+
+        auto line_as_list = utl::split_string_by_character(line, ',');
+        if (line_as_list.size() != 3)
+        {
+            std::cout << "Invalid contention line, expected <type>,<num_concurrent>,<slowdown>." << std::endl;
+            exit(1);
+        }
+        auto type = OperationType(line_as_list[0]);
+        auto slowdown = std::stod(line_as_list[2]);
+        if (slowdown <= 0)
+        {
+            std::cout << "Invalid contention line " << line << ", the slowdown must be positive." << std::endl;
+            exit(1);
+        }
+        points[type][std::stoi(line_as_list[1])] = slowdown;
+    }
+}
+
+bool ContentionCurve::is_empty() const
+{
+    return points.empty();
+}
+
+bool ContentionCurve::affects(OperationType::Type type) const
+{
+    return points.contains(type);
+}
+
+double ContentionCurve::get_slowdown(OperationType::Type type, int num_concurrent) const
+{
+    if (!affects(type))
+    {
+        return 1;
+    }
+
+    const auto &curve = points.at(type);
+    if (curve.size() == 1 || num_concurrent <= curve.begin()->first)
+    {
+        return curve.begin()->second;
+    }
+
+    auto upper = curve.lower_bound(num_concurrent);
+    bool is_extrapolated = upper == curve.end();
+    if (is_extrapolated)
+    {
+        upper = std::prev(curve.end());
+    }
+    auto lower = std::prev(upper);
+
+    auto [x0, y0] = *lower;
+    auto [x1, y1] = *upper;
+    auto slowdown = y0 + (y1 - y0) * (num_concurrent - x0) / (x1 - x0);
+    // A curve that flattens or dips at its end is held at its last point,
+    // so the slowdown never drops to zero or below.
+    return is_extrapolated ? std::max(slowdown, y1) : slowdown;
+}
@@ -0,0 +1,32 @@
+#ifndef contention_curve_INCLUDED_
+#define contention_curve_INCLUDED_
+
+#include "operation.h"
+#include "shared_utils.h"
+
+// How much BOOT and MUL operations slow down when several of them run at
+// once and compete for memory bandwidth.
+//
+// Each line of the file is "<type>,<num_concurrent>,<slowdown>", where
+// <num_concurrent> counts every running BOOT and MUL task and <slowdown>
+// multiplies the task's uncontended latency and must be positive.
+// Slowdowns between listed points are interpolated linearly. Past the last
+// point they are extrapolated from the last two points, but never below
+// the last slowdown. Types without points never slow down.
+class ContentionCurve
+{
+public:
+    ContentionCurve(){};
+    ContentionCurve(const std::string &);
+
+    bool is_empty() const;
+    bool affects(OperationType::Type) const;
+    double get_slowdown(OperationType::Type, int) const;
+
+private:
+    std::map<OperationType::Type, std::map<int, double>> points;
+
+    void parse_curve_file(const std::string &);
+};
+
+#endif
@@ -0,0 +1,466 @@
+#include "exact_scheduler.h"
+
+ExactScheduler::ExactScheduler(int argc, char **argv)
+{
+    parse_args(argc, argv);
+    print_options();
+
+    Program::ConstructorInput in;
+    in.dag_filename = options.dag_filename;
+    in.latency_filename = options.latency_filename;
+    in.bootstrap_filename = options.bootstrap_filename;
+
+    program = Program(in);
+
+    initialize_tasks();
+    initialize_tails();
+}
+
+// Operation tasks share the index of their operation, minus one, and the
+// bootstrap tasks follow. Bootstraps may feed lower numbered tasks, so
+// the topological order puts each bootstrap right after its operation.
+void ExactScheduler::initialize_tasks()
+{
+    std::vector<int> bootstrap_task_of(program.size() + 1, -1);
+    for (const auto &operation : program)
+    {
+        tasks.push_back({operation, false, program.get_latency_of(operation), {}, {}});
+    }
+    for (const auto &operation : program)
+    {
+        if (operation->is_bootstrapped())
+        {
+            bootstrap_task_of[operation->id] = tasks.size();
+            tasks.push_back({operation, true, program.get_bootstrap_latency_of(operation), {operation->id - 1}, {}});
+        }
+    }
+
+    for (const auto &operation : program)
+    {
+        auto &task = tasks[operation->id - 1];
+        for (const auto &parent : operation->parent_ptrs)
+        {
+            auto pred = operation->receives_bootstrapped_result_from(parent)
+                            ? bootstrap_task_of[parent->id]
+                            : parent->id - 1;
+            task.preds.push_back(pred);
+        }
+    }
+
+    for (const auto &operation : program)
+    {
+        topological_order.push_back(operation->id - 1);
+        if (bootstrap_task_of[operation->id] >= 0)
+        {
+            topological_order.push_back(bootstrap_task_of[operation->id]);
+        }
+    }
+
+    for (size_t task_index = 0; task_index < tasks.size(); task_index++)
+    {
+        for (auto pred : tasks[task_index].preds)
+        {
+            tasks[pred].succs.push_back(task_index);
+        }
+        total_work += tasks[task_index].latency;
+    }
+}
+
+void ExactScheduler::initialize_tails()
+{
+    for (auto task_index : topological_order | std::views::reverse)
+    {
+        auto &task = tasks[task_index];
+        task.tail = task.latency;
+        for (auto succ : task.succs)
+        {
+            task.tail = std::max(task.tail, task.latency + tasks[succ].tail);
+        }
+    }
+}
+
+void ExactScheduler::initialize_search_state()
+{
+    start_times.assign(tasks.size(), -1);
+    finish_times.assign(tasks.size(), 0);
+    num_unscheduled_preds.resize(tasks.size());
+    for (size_t task_index = 0; task_index < tasks.size(); task_index++)
+    {
+        num_unscheduled_preds[task_index] = tasks[task_index].preds.size();
+    }
+    core_free_times.assign(options.num_threads, 0);
+    order.clear();
+    scheduled.assign((tasks.size() + 63) / 64, 0);
+    remaining_work = total_work;
+    makespan = 0;
+}
+
+void ExactScheduler::perform_exact_scheduling()
+{
+    best_makespan = get_greedy_makespan();
+
+    initialize_search_state();
+    root_lower_bound = get_lower_bound(0);
+    search(0, -1);
+
+    apply_best_order();
+}
+
+// Follows the first branch of the search to its end, which is a list
+// schedule by earliest start and then longest tail. Gives the search a
+// good first bound.
+int ExactScheduler::get_greedy_makespan()
+{
+    initialize_search_state();
+    while (order.size() < tasks.size())
+    {
+        auto [start_time, task_index] = get_candidates(-1, -1).front();
+        place_task(task_index, start_time);
+    }
+    best_order = order;
+    return makespan;
+}
+
+// Every node places one more task, starting no earlier than the last one.
+void ExactScheduler::search(int last_start, int last_task)
+{
+    num_nodes++;
+    if (order.size() == tasks.size())
+    {
+        if (makespan < best_makespan)
+        {
+            best_makespan = makespan;
+            best_order = order;
+        }
+        return;
+    }
+
+    if (num_nodes % 1024 == 0 && options.time_budget.expired())
+    {
+        proven_optimal = false;
+    }
+    if (!proven_optimal || get_lower_bound(last_start) >= best_makespan || is_dominated(last_start, last_task))
+    {
+        return;
+    }
+
+    for (auto [start_time, task_index] : get_candidates(last_start, last_task))
+    {
+        auto saved_core_free_times = core_free_times;
+        auto saved_makespan = makespan;
+        place_task(task_index, start_time);
+        search(start_time, task_index);
+        unplace_task(task_index, saved_makespan, saved_core_free_times);
+    }
+}
+
+// The ready tasks that can be placed next, earliest start first and
+// longest tail first among equal starts.
+std::vector<std::pair<int, int>> ExactScheduler::get_candidates(int last_start, int last_task) const
+{
+    std::vector<std::pair<int, int>> candidates;
+    for (size_t task_index = 0; task_index < tasks.size(); task_index++)
+    {
+        if (start_times[task_index] >= 0 || num_unscheduled_preds[task_index] > 0)
+        {
+            continue;
+        }
+        auto start_time = std::max(core_free_times.front(), get_ready_time(task_index));
+        if (start_time > last_start || (start_time == last_start && int(task_index) > last_task))
+        {
+            candidates.emplace_back(start_time, task_index);
+        }
+    }
+
+    std::ranges::sort(candidates, [this](const auto &a, const auto &b)
+                      {
+                          if (a.first != b.first)
+                          {
+                              return a.first < b.first;
+                          }
+                          return tasks[a.second].tail > tasks[b.second].tail;
+                      });
+    return candidates;
+}
+
+int ExactScheduler::get_ready_time(int task_index) const
+{
+    int ready_time = 0;
+    for (auto pred : tasks[task_index].preds)
+    {
+        ready_time = std::max(ready_time, finish_times[pred]);
+    }
+    return ready_time;
+}
+
+// The larger of the critical path through the unscheduled tasks and the
+// remaining work spread over the cores. No task starts before last_start.
+int ExactScheduler::get_lower_bound(int last_start) const
+{
+    auto earliest_start = std::max(last_start, core_free_times.front());
+    int critical_path = makespan;
+    std::vector<int> earliest_finish_times(tasks.size());
+    for (size_t task_index = 0; task_index < tasks.size(); task_index++)
+    {
+        if (start_times[task_index] >= 0)
+        {
+            earliest_finish_times[task_index] = finish_times[task_index];
+        }
+    }
+    for (auto task_index : topological_order)
+    {
+        if (start_times[task_index] >= 0)
+        {
+            continue;
+        }
+        int start_time = earliest_start;
+        for (auto pred : tasks[task_index].preds)
+        {
+            start_time = std::max(start_time, earliest_finish_times[pred]);
+        }
+        earliest_finish_times[task_index] = start_time + tasks[task_index].latency;
+        critical_path = std::max(critical_path, start_time + tasks[task_index].tail);
+    }
+
+    int busy_time = remaining_work;
+    for (auto core_free_time : core_free_times)
+    {
+        busy_time += std::max(core_free_time, last_start);
+    }
+    int total_work_bound = (busy_time + options.num_threads - 1) / options.num_threads;
+
+    return std::max(critical_path, total_work_bound);
+}
+
+// Remembers the partial schedule, unless an earlier partial schedule of
+// the same tasks was at least as good in every respect.
+bool ExactScheduler::is_dominated(int last_start, int last_task)
+{
+    auto state = get_memo_state(last_start, last_task);
+    auto it = memo.find(scheduled);
+    if (it != memo.end())
+    {
+        for (const auto &other : it->second)
+        {
+            if (dominates(other, state))
+            {
+                return true;
+            }
+        }
+    }
+    if (num_memo_states < options.max_memo_states)
+    {
+        memo[scheduled].push_back(std::move(state));
+        num_memo_states++;
+    }
+    return false;
+}
+
+ExactScheduler::MemoState ExactScheduler::get_memo_state(int last_start, int last_task) const
+{
+    MemoState state{core_free_times, {}, makespan, last_start, last_task};
+    for (size_t task_index = 0; task_index < tasks.size(); task_index++)
+    {
+        if (start_times[task_index] < 0)
+        {
+            continue;
+        }
+        auto is_frontier = std::ranges::any_of(tasks[task_index].succs, [this](int succ)
+                                               { return start_times[succ] < 0; });
+        if (is_frontier)
+        {
+            state.frontier_finish_times.push_back(finish_times[task_index]);
+        }
+    }
+    return state;
+}
+
+// Both states have the same tasks placed, so their frontier finish times
+// belong to the same tasks.
+bool ExactScheduler::dominates(const MemoState &a, const MemoState &b)
+{
+    if (a.makespan > b.makespan ||
+        std::tie(a.last_start, a.last_task) > std::tie(b.last_start, b.last_task))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.core_free_times.size(); i++)
+    {
+        if (a.core_free_times[i] > b.core_free_times[i])
+        {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.frontier_finish_times.size(); i++)
+    {
+        if (a.frontier_finish_times[i] > b.frontier_finish_times[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The task goes on the core that frees up first.
+void ExactScheduler::place_task(int task_index, int start_time)
+{
+    const auto &task = tasks[task_index];
+    start_times[task_index] = start_time;
+    finish_times[task_index] = start_time + task.latency;
+    for (auto succ : task.succs)
+    {
+        num_unscheduled_preds[succ]--;
+    }
+    core_free_times.front() = finish_times[task_index];
+    std::ranges::sort(core_free_times);
+    order.push_back(task_index);
+    scheduled[task_index / 64] |= uint64_t(1) << (task_index % 64);
+    remaining_work -= task.latency;
+    makespan = std::max(makespan, finish_times[task_index]);
+}
+
+void ExactScheduler::unplace_task(int task_index, int saved_makespan, const std::vector<int> &saved_core_free_times)
+{
+    const auto &task = tasks[task_index];
+    start_times[task_index] = -1;
+    finish_times[task_index] = 0;
+    for (auto succ : task.succs)
+    {
+        num_unscheduled_preds[succ]++;
+    }
+    core_free_times = saved_core_free_times;
+    order.pop_back();
+    scheduled[task_index / 64] &= ~(uint64_t(1) << (task_index % 64));
+    remaining_work += task.latency;
+    makespan = saved_makespan;
+}
+
+// Replays the best order on numbered cores. Ties between cores go to the
+// lowest number, which gives the same start times as the search.
+void ExactScheduler::apply_best_order()
+{
+    std::vector<int> core_finish_times(options.num_threads + 1, 0);
+    std::vector<int> task_finish_times(tasks.size(), 0);
+    for (auto task_index : best_order)
+    {
+        const auto &task = tasks[task_index];
+        int core_num = 1;
+        for (int core = 2; core <= options.num_threads; core++)
+        {
+            if (core_finish_times[core] < core_finish_times[core_num])
+            {
+                core_num = core;
+            }
+        }
+
+        int start_time = core_finish_times[core_num];
+        for (auto pred : task.preds)
+        {
+            start_time = std::max(start_time, task_finish_times[pred]);
+        }
+        task_finish_times[task_index] = start_time + task.latency;
+        core_finish_times[core_num] = task_finish_times[task_index];
+
+        if (task.is_bootstrap)
+        {
+            task.operation->bootstrap_start_time = start_time;
+            task.operation->bootstrap_core_num = core_num;
+        }
+        else
+        {
+            task.operation->start_time = start_time;
+            task.operation->core_num = core_num;
+        }
+    }
+}
+
+void ExactScheduler::parse_args(int argc, char **argv)
+{
+    const int minimum_arguments = 3;
+
+    if (argc < minimum_arguments)
+    {
+        std::cout << help_info << std::endl;
+        exit(1);
+    }
+
+    options.dag_filename = argv[1];
+    options.output_filename = argv[2];
+
+    std::string options_string = utl::make_options_string(argc, argv, minimum_arguments);
+
+    auto num_threads_string = utl::get_arg(options_string, "-t", "--num-threads", help_info);
+    if (!num_threads_string.empty())
+    {
+        options.num_threads = std::stoi(num_threads_string);
+    }
+
+    auto bootstrap_arg = utl::get_arg(options_string, "-i", "--input-lgr", help_info);
+    if (!bootstrap_arg.empty())
+    {
+        options.bootstrap_filename = bootstrap_arg;
+    }
+
+    auto latency_arg = utl::get_arg(options_string, "-l", "--latency-file", help_info);
+    if (!latency_arg.empty())
+    {
+        options.latency_filename = latency_arg;
+    }
+
+    options.time_budget = utl::get_time_budget_arg(options_string, help_info);
+
+    auto max_memo_states_string = utl::get_arg(options_string, "-m", "--max-memo-states", help_info);
+    if (!max_memo_states_string.empty())
+    {
+        options.max_memo_states = std::stoul(max_memo_states_string);
+    }
+}
+
+void ExactScheduler::print_options() const
+{
+    std::cout << "dag_filename: " << options.dag_filename << std::endl;
+    std::cout << "latency_filename: " << options.latency_filename << std::endl;
+    std::cout << "output_filename: " << options.output_filename << std::endl;
+    std::cout << "bootstrap_filename: " << options.bootstrap_filename << std::endl;
+    std::cout << "num_threads: " << options.num_threads << std::endl;
+    std::cout << "max_memo_states: " << options.max_memo_states << std::endl;
+}
+
+void ExactScheduler::write_to_output_files() const
+{
+    auto file_writer = FileWriter(std::ref(program));
+    file_writer.write_lgr_info_to_file(options.output_filename + ".lgr", best_makespan);
+    file_writer.write_sched_file(options.output_filename + ".sched");
+}
+
+std::string ExactScheduler::get_log_filename() const
+{
+    return options.output_filename + ".log";
+}
+
+void ExactScheduler::write_search_summary(std::ofstream &log_file) const
+{
+    log_file << "makespan: " << best_makespan << std::endl;
+    log_file << "proven_optimal: " << (proven_optimal ? "true" : "false") << std::endl;
+    log_file << "root_lower_bound: " << root_lower_bound << std::endl;
+    log_file << "nodes: " << num_nodes << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    ExactScheduler exact_scheduler = ExactScheduler(argc, argv);
+
+    std::ofstream log_file(exact_scheduler.get_log_filename());
+
+    std::function<void()> main_func = [&exact_scheduler]()
+    {
+        exact_scheduler.perform_exact_scheduling();
+        exact_scheduler.write_to_output_files();
+    };
+
+    utl::perform_func_and_print_execution_time(main_func, log_file);
+
+    exact_scheduler.write_search_summary(log_file);
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include "shared_utils.h"
+#include "program.h"
+#include "file_writer.h"
+
+#include <vector>
+#include <unordered_map>
+#include <numeric>
+
+class ExactScheduler
+{
+public:
+  ExactScheduler(int, char **);
+
+  void perform_exact_scheduling();
+
+  void write_to_output_files() const;
+
+  std::string get_log_filename() const;
+  void write_search_summary(std::ofstream &) const;
+
+private:
+  const std::string help_info = R"(
+Usage: ./exact_scheduler.out <dag_file>
+                             <output_file>
+                             [<options>]
+
+Finds a schedule with the shortest makespan by depth-first branch and
+bound, and writes <output_file>.lgr, <output_file>.sched, and
+<output_file>.log. Operations and bootstraps are tasks on identical
+cores, as in list_scheduler.out without a machine file. Meant for
+graphs of up to a few hundred operations.
+
+The search places one task at a time on the core that frees up first,
+which is enough to reach an optimal schedule. Tasks are placed in order
+of start time, so each schedule is only built once, and cores with equal
+free times are interchangeable. A partial schedule is pruned when the
+critical path or the remaining work over the cores shows it cannot beat
+the best schedule so far, or when an earlier partial schedule of the
+same tasks had every core, input, and the makespan ready no later.
+
+The log holds the execution time, the makespan, whether it was proven
+optimal, the root lower bound, and the number of explored nodes.
+
+Options:
+  -l <file>, --latency-file=<file>
+    A file describing the latencies of FHE operations on the target
+    hardware. The default values can be found in program.h.
+    Lines of the form <type>,<levels>,<latency> give the latency of an
+    operation whose inputs have <levels> levels left. The largest listed
+    level is the level of fresh and bootstrapped ciphertexts.
+  -t <int>, --num-threads=<int>
+    The number of threads on which operations may be scheduled.
+    Defaults to 1.
+  -i <file/"NULL">, --input-lgr=<file/"NULL">
+    A path to a .lgr file specifying a set of operations to bootstrap.
+    Setting to "NULL" means scheduling will be performed without
+    bootstrapping. Defaults to "NULL".
+  -T <float>, --time-budget=<float>
+    A wall-clock budget in seconds. When it expires, the best schedule
+    found so far is written and is not proven optimal.
+  -m <int>, --max-memo-states=<int>
+    The largest number of partial schedules remembered for pruning.
+    Defaults to 1000000.)";
+
+  struct Options
+  {
+    std::string dag_filename;
+    std::string latency_filename;
+    std::string output_filename;
+    std::string bootstrap_filename = "NULL";
+    int num_threads = 1;
+    utl::TimeBudget time_budget;
+    size_t max_memo_states = 1000000;
+  } options;
+
+  // An operation or the bootstrap of its result. Tasks are numbered in
+  // topological order.
+  struct Task
+  {
+    OperationPtr operation;
+    bool is_bootstrap;
+    int latency;
+    std::vector<int> preds;
+    std::vector<int> succs;
+    // The longest path from the start of the task to the end of the program.
+    int tail = 0;
+  };
+
+  // What a stored partial schedule needs to dominate another one of the
+  // same tasks.
+  struct MemoState
+  {
+    std::vector<int> core_free_times;
+    std::vector<int> frontier_finish_times;
+    int makespan;
+    int last_start;
+    int last_task;
+  };
+
+  using TaskBitset = std::vector<uint64_t>;
+
+  struct TaskBitsetHash
+  {
+    size_t operator()(const TaskBitset &bitset) const
+    {
+      size_t seed = bitset.size();
+      for (auto word : bitset)
+      {
+        seed ^= std::hash<uint64_t>{}(word) + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+      }
+      return seed;
+    }
+  };
+
+  Program program;
+  std::vector<Task> tasks;
+  std::vector<int> topological_order;
+  int total_work = 0;
+
+  // The state of the current partial schedule. Core free times are kept
+  // sorted, since identical cores are interchangeable.
+  std::vector<int> start_times;
+  std::vector<int> finish_times;
+  std::vector<int> num_unscheduled_preds;
+  std::vector<int> core_free_times;
+  std::vector<int> order;
+  TaskBitset scheduled;
+  int remaining_work = 0;
+  int makespan = 0;
+
+  std::vector<int> best_order;
+  int best_makespan;
+  int root_lower_bound = 0;
+  bool proven_optimal = true;
+  size_t num_nodes = 0;
+  size_t num_memo_states = 0;
+
+  std::unordered_map<TaskBitset, std::vector<MemoState>, TaskBitsetHash> memo;
+
+  void initialize_tasks();
+  void initialize_tails();
+  void initialize_search_state();
+  void search(int, int);
+  std::vector<std::pair<int, int>> get_candidates(int, int) const;
+  int get_ready_time(int) const;
+  int get_lower_bound(int) const;
+  bool is_dominated(int, int);
+  MemoState get_memo_state(int, int) const;
+  static bool dominates(const MemoState &, const MemoState &);
+  void place_task(int, int);
+  void unplace_task(int, int, const std::vector<int> &);
+  int get_greedy_makespan();
+  void apply_best_order();
+
+  void parse_args(int, char **);
+  void print_options() const;
+};
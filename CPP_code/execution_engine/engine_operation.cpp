@@ -97,4 +97,30 @@ void EngineOperation::print() const
     }
     std::cout << std::endl;
     std::cout << "Output: " << output_key << std::endl;
+}
+
+std::string get_op_type_name(EngineOpType op_type)
+{
+    switch (op_type)
+    {
+    case CC_MUL:
+        return "CC_MUL";
+    case CP_MUL:
+        return "CP_MUL";
+    case CC_ADD:
+        return "CC_ADD";
+    case CP_ADD:
+        return "CP_ADD";
+    case CC_SUB:
+        return "CC_SUB";
+    case CP_SUB:
+        return "CP_SUB";
+    case PC_SUB:
+        return "PC_SUB";
+    case INV:
+        return "INV";
+    case BOOT:
+        return "BOOT";
+    }
+    return "UNKNOWN";
 }
\ No newline at end of file
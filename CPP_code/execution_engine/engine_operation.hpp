@@ -56,4 +56,6 @@ private:
     void set_op_type(const std::string &in_op);
 };
 
-using EngineOperationPtr = std::shared_ptr<EngineOperation>;
\ No newline at end of file
+using EngineOperationPtr = std::shared_ptr<EngineOperation>;
+
+std::string get_op_type_name(EngineOpType);
\ No newline at end of file
@@ -24,6 +24,15 @@ ExecutionEngine::ExecutionEngine(int argc, char **argv)
 
 void ExecutionEngine::execute()
 {
+  engine_start_time = std::chrono::steady_clock::now();
+
+  if (options.mode == ExecMode::CALIBRATE)
+  {
+    setup_crypto_context();
+    calibrate_latencies();
+    return;
+  }
+
   parse_schedule();
 
   generate_data_structures();
@@ -61,20 +70,40 @@ void ExecutionEngine::parse_schedule()
     ScheduleParser parser;
     sched_info = parser.parse(options);
   };
-  utl::perform_func_and_print_execution_time(parser_func, "Parsing schedule");
+  perform_phase(parser_func, "Parsing schedule");
 
-  omp_set_num_threads(sched_info.circuit.size());
+  omp_set_num_threads(get_num_workers());
 }
 
 void ExecutionEngine::generate_data_structures()
 {
   std::function<void()> struct_funcs = [this]()
   {
+    generate_registers();
     generate_inputs();
-    generate_reg_locks();
-    generate_dependence_locks();
+    generate_ready_flags();
+    generate_reg_waiters();
+    operation_memory_samples.assign(options.memory_profile ? sched_info.get_num_regs() : 0, {});
+    generate_trace_buffers();
+    if (options.mode == ExecMode::DYNAMIC)
+    {
+      generate_task_graph();
+    }
   };
-  utl::perform_func_and_print_execution_time(struct_funcs, "Generating inputs and mutexes");
+  perform_phase(struct_funcs, "Generating inputs and mutexes");
+}
+
+void ExecutionEngine::generate_registers()
+{
+  auto num_regs = sched_info.get_num_regs();
+  ctxt_regs.assign(num_regs, nullptr);
+  ptxt_regs.assign(num_regs, nullptr);
+  validation_regs.assign(num_regs, 0.0);
+  remaining_uses = std::vector<std::atomic<int>>(num_regs);
+  for (size_t reg = 0; reg < num_regs; reg++)
+  {
+    remaining_uses[reg].store(sched_info.num_uses[reg]);
+  }
 }
 
 void ExecutionEngine::generate_inputs()
@@ -99,69 +128,97 @@ void ExecutionEngine::generate_inputs()
 
 void ExecutionEngine::generate_constant_inputs()
 {
-  for (const auto &input : sched_info.initial_inputs)
+  for (auto reg : sched_info.initial_inputs)
   {
-    validation_regs[input.key] = options.inputs_value;
+    validation_regs[reg] = options.inputs_value;
   }
 }
 
 void ExecutionEngine::generate_random_inputs()
 {
-  for (const auto &input : sched_info.initial_inputs)
+  for (auto reg : sched_info.initial_inputs)
   {
-    validation_regs[input.key] = static_cast<double>(rand()) / static_cast<double>(RAND_MAX / options.rand_thresh);
+    validation_regs[reg] = static_cast<double>(rand()) / static_cast<double>(RAND_MAX / options.rand_thresh);
   }
 }
 
 void ExecutionEngine::generate_inputs_from_file()
 {
   std::ifstream inputs_file(options.inputs_filename);
+  std::map<std::string, double> input_values;
 
   auto line = utl::get_trimmed_line_from_file(inputs_file);
   while (!line.empty())
   {
     auto line_as_list = utl::split_string_by_character(line, ',');
-    validation_regs[line_as_list[0]] = std::stod(line_as_list[1]);
+    input_values[line_as_list[0]] = std::stod(line_as_list[1]);
     line = utl::get_trimmed_line_from_file(inputs_file);
   }
 
-  if (validation_regs.size() != sched_info.initial_inputs.size())
+  if (input_values.size() != sched_info.initial_inputs.size())
   {
     std::cout << "Invalid inputs file. Number of inputs does not match schedule." << std::endl;
     exit(1);
   }
 
-  for (const auto &input : sched_info.initial_inputs)
+  for (auto reg : sched_info.initial_inputs)
   {
-    if (!validation_regs.count(input.key))
+    const auto &key = sched_info.reg_keys[reg];
+    if (!input_values.count(key))
     {
-      std::cout << "Invalid inputs file. Missing input with key " << input.key << "." << std::endl;
+      std::cout << "Invalid inputs file. Missing input with key " << key << "." << std::endl;
       exit(1);
     }
+    validation_regs[reg] = input_values[key];
   }
 }
 
-void ExecutionEngine::generate_reg_locks()
+void ExecutionEngine::generate_ready_flags()
 {
-  reg_locks.clear();
-  for (uint64_t i = 0; i < sched_info.circuit.size(); i++)
+  reg_ready = std::vector<std::atomic<bool>>(sched_info.get_num_regs());
+  for (size_t reg = 0; reg < reg_ready.size(); reg++)
   {
-    for (const auto &operation : sched_info.circuit[i])
-    {
-      auto output_key = operation->get_output();
-      reg_locks.emplace(output_key, new std::mutex);
-      reg_locks[output_key]->lock();
-    }
+    reg_ready[reg].store(!sched_info.reg_is_output[reg]);
   }
 }
 
-void ExecutionEngine::generate_dependence_locks()
+void ExecutionEngine::generate_reg_waiters()
 {
-  dependence_locks.clear();
-  for (const auto &[input_key, _] : sched_info.dependent_outputs)
+  if (options.num_workers > 0)
   {
-    dependence_locks.emplace(input_key, new std::mutex);
+    reg_waiter_locks = std::vector<std::mutex>(sched_info.get_num_regs());
+    reg_waiters.assign(sched_info.get_num_regs(), {});
+  }
+}
+
+size_t ExecutionEngine::get_num_workers() const
+{
+  return options.num_workers > 0 ? options.num_workers : sched_info.get_num_threads();
+}
+
+void ExecutionEngine::generate_task_graph()
+{
+  const auto num_instructions = sched_info.instructions.size();
+  unready_inputs = std::vector<std::atomic<int>>(num_instructions);
+  reg_consumers.assign(sched_info.get_num_regs(), {});
+  for (size_t i = 0; i < num_instructions; i++)
+  {
+    const auto &instruction = sched_info.instructions[i];
+    int num_unready = 0;
+    for (int j = 0; j < instruction.num_inputs; j++)
+    {
+      auto reg = instruction.input_regs[j];
+      if (sched_info.reg_is_output[reg])
+      {
+        reg_consumers[reg].push_back(i);
+        num_unready++;
+      }
+    }
+    unready_inputs[i].store(num_unready);
   }
+
+  worker_queues = std::vector<WorkerQueue>(get_num_workers());
+  work_epoch.store(0);
 }
 
 void ExecutionEngine::execute_in_plaintext()
@@ -169,86 +226,229 @@ void ExecutionEngine::execute_in_plaintext()
   std::function<void()> ptxt_func = [this]()
   {
     execute_validation_schedule();
-    lock_all_mutexes();
+    reset_ready_flags();
   };
-  utl::perform_func_and_print_execution_time(ptxt_func, "Executing in plaintext");
+  perform_phase(ptxt_func, "Executing in plaintext");
 }
 
 void ExecutionEngine::execute_validation_schedule()
 {
+  std::function<void(const EngineInstruction &)> execute_func = [this](const EngineInstruction &instruction)
+  { execute_validation_instruction(instruction); };
+  run_schedule_threads(execute_func);
+}
+
+void ExecutionEngine::execute_validation_instruction(const EngineInstruction &instruction)
+{
+  const auto &inputs = instruction.input_regs;
+  auto input1 = validation_regs[inputs[0]];
+  double input2=0;//Mihailo put this value to 0 to solve issues of warning being treated as errors
+  if (instruction.num_inputs == 2)
+  {
+    input2 = validation_regs[inputs[1]];
+  }
+  double result;
+  switch (instruction.op_type)
+  {
+  case CP_MUL:
+  case CC_MUL:
+    result = input1 * input2;
+    break;
+  case CP_ADD:
+  case CC_ADD:
+    result = input1 + input2;
+    break;
+  case CP_SUB:
+  case CC_SUB:
+    result = input1 - input2;
+    break;
+  case PC_SUB:
+    result = input2 - input1;
+    break;
+  case INV:
+    result = -input1;
+    break;
+  case BOOT:
+    result = input1;
+    break;
+  default:
+    std::cout << "Invalid Instruction! Exiting..." << std::endl;
+    exit(-1);
+  }
+
+  validation_regs[instruction.output_reg] = result;
+
+  mark_ready(instruction.output_reg);
+}
+
+void ExecutionEngine::run_schedule_threads(const std::function<void(const EngineInstruction &)> &execute_func)
+{
+  if (options.num_workers > 0)
+  {
+    run_coroutine_workers(execute_func);
+    return;
+  }
+
 #pragma omp parallel for
-  for (size_t i = 0; i < sched_info.circuit.size(); i++)
+  for (size_t t = 0; t < sched_info.get_num_threads(); t++)
   {
-    for (const auto &operation : sched_info.circuit[i])
+    for (size_t i = sched_info.thread_offsets[t]; i < sched_info.thread_offsets[t + 1]; i++)
     {
-      auto output_key = operation->get_output();
-      auto inputs = operation->get_inputs();
-      handle_input_mutex(inputs[0].key);
-      if (inputs.size() == 2)
+      const auto &instruction = sched_info.instructions[i];
+      auto wait_start = get_trace_time();
+      wait_for_inputs(instruction);
+      set_trace_wait_start(wait_start);
+      execute_func(instruction);
+    }
+  }
+}
+
+void ExecutionEngine::run_coroutine_workers(const std::function<void(const EngineInstruction &)> &execute_func)
+{
+  const auto num_threads = sched_info.get_num_threads();
+  std::atomic<size_t> num_finished = 0;
+
+  std::vector<ScheduleThread> schedule_threads;
+  for (size_t t = 0; t < num_threads; t++)
+  {
+    schedule_threads.push_back(run_schedule_thread(t, execute_func, num_finished));
+    runnable_threads.push_back(schedule_threads.back().handle);
+  }
+
+#pragma omp parallel
+  {
+    while (num_finished.load() < num_threads)
+    {
+      auto epoch = work_epoch.load();
+      std::coroutine_handle<> handle;
+      runnable_lock.lock();
+      if (!runnable_threads.empty())
       {
-        handle_input_mutex(inputs[1].key);
+        handle = runnable_threads.front();
+        runnable_threads.pop_front();
       }
-      map_lock.lock();
-      auto input1 = validation_regs[inputs[0].key];
-      double input2=0;//Mihailo put this value to 0 to solve issues of warning being treated as errors
-      if (inputs.size() == 2)
+      runnable_lock.unlock();
+
+      if (handle)
       {
-        input2 = validation_regs[inputs[1].key];
+        handle.resume();
       }
-      map_lock.unlock();
-      double result;
-      switch (operation->get_op_type())
+      else
       {
-      case CP_MUL:
-      case CC_MUL:
-        result = input1 * input2;
-        break;
-      case CP_ADD:
-      case CC_ADD:
-        result = input1 + input2;
-        break;
-      case CP_SUB:
-      case CC_SUB:
-        result = input1 - input2;
-        break;
-      case PC_SUB:
-        result = input2 - input1;
-        break;
-      case INV:
-        result = -input1;
-        break;
-      case BOOT:
-        result = input1;
-        break;
-      default:
-        std::cout << "Invalid Instruction! Exiting..." << std::endl;
-        exit(-1);
+        work_epoch.wait(epoch);
       }
+    }
+  }
 
-      map_lock.lock();
-      validation_regs[output_key] = result;
-      map_lock.unlock();
+  for (auto &schedule_thread : schedule_threads)
+  {
+    schedule_thread.handle.destroy();
+  }
+}
 
-      reg_locks[output_key]->unlock();
+ExecutionEngine::ScheduleThread ExecutionEngine::run_schedule_thread(
+    size_t t, const std::function<void(const EngineInstruction &)> &execute_func, std::atomic<size_t> &num_finished)
+{
+  for (size_t i = sched_info.thread_offsets[t]; i < sched_info.thread_offsets[t + 1]; i++)
+  {
+    const auto &instruction = sched_info.instructions[i];
+    auto wait_start = get_trace_time();
+    for (int j = 0; j < instruction.num_inputs; j++)
+    {
+      co_await RegisterAwaiter{this, instruction.input_regs[j]};
     }
+    // The coroutine may have been resumed by another worker.
+    set_trace_wait_start(wait_start);
+    execute_func(instruction);
+  }
+
+  if (++num_finished == sched_info.get_num_threads())
+  {
+    work_epoch++;
+    work_epoch.notify_all();
   }
-  return;
 }
 
-void ExecutionEngine::handle_input_mutex(const std::string &input_key)
+bool ExecutionEngine::RegisterAwaiter::await_ready() const
 {
-  if (reg_locks.count(input_key))
+  return engine->reg_ready[reg].load(std::memory_order_acquire);
+}
+
+bool ExecutionEngine::RegisterAwaiter::await_suspend(std::coroutine_handle<> handle) const
+{
+  // The ready flag is checked again under the waiter lock, since mark_ready
+  // sets it before taking the lock to wake the waiters.
+  auto &lock = engine->reg_waiter_locks[reg];
+  lock.lock();
+  if (engine->reg_ready[reg].load(std::memory_order_acquire))
+  {
+    lock.unlock();
+    return false;
+  }
+  engine->reg_waiters[reg].push_back(handle);
+  lock.unlock();
+  return true;
+}
+
+void ExecutionEngine::resume_waiters(int reg)
+{
+  reg_waiter_locks[reg].lock();
+  auto waiters = std::move(reg_waiters[reg]);
+  reg_waiters[reg].clear();
+  reg_waiter_locks[reg].unlock();
+
+  if (waiters.empty())
+  {
+    return;
+  }
+
+  runnable_lock.lock();
+  runnable_threads.insert(runnable_threads.end(), waiters.begin(), waiters.end());
+  runnable_lock.unlock();
+
+  work_epoch++;
+  work_epoch.notify_all();
+}
+
+void ExecutionEngine::wait_for_inputs(const EngineInstruction &instruction)
+{
+  for (int i = 0; i < instruction.num_inputs; i++)
+  {
+    wait_until_ready(instruction.input_regs[i]);
+  }
+}
+
+void ExecutionEngine::wait_until_ready(int reg)
+{
+  auto &ready = reg_ready[reg];
+  for (int i = 0; i < ready_spin_iterations; i++)
+  {
+    if (ready.load(std::memory_order_acquire))
+    {
+      return;
+    }
+  }
+  while (!ready.load(std::memory_order_acquire))
   {
-    reg_locks[input_key]->lock();
-    reg_locks[input_key]->unlock();
+    ready.wait(false, std::memory_order_acquire);
   }
 }
 
-void ExecutionEngine::lock_all_mutexes()
+void ExecutionEngine::mark_ready(int reg)
 {
-  for (auto &[key, mutex] : reg_locks)
+  reg_ready[reg].store(true, std::memory_order_release);
+  reg_ready[reg].notify_all();
+  if (options.num_workers > 0)
   {
-    mutex->lock();
+    resume_waiters(reg);
+  }
+}
+
+void ExecutionEngine::reset_ready_flags()
+{
+  for (const auto &instruction : sched_info.instructions)
+  {
+    reg_ready[instruction.output_reg].store(false);
   }
 }
 
@@ -256,8 +456,9 @@ void ExecutionEngine::print_test_info() const
 {
   int good_count = 0;
   int bad_count = 0;
-  for (auto &[key, value] : validation_regs)
+  for (size_t reg = 0; reg < validation_regs.size(); reg++)
   {
+    auto value = validation_regs[reg];
     if (abs(value) > 0.000001 && abs(value) < 10000)
     {
       good_count++;
@@ -266,7 +467,7 @@ void ExecutionEngine::print_test_info() const
     {
       bad_count++;
     }
-    std::cout << key << ": " << value << std::endl;
+    std::cout << sched_info.reg_keys[reg] << ": " << value << std::endl;
   }
   std::cout << "good values: " << good_count << std::endl;
   std::cout << "bad values: " << bad_count << std::endl;
@@ -304,8 +505,26 @@ void ExecutionEngine::setup_crypto_context()
     // std::cout << "ctxt_level_after_bootstrap: " << ctxt_level_after_bootstrap << std::endl;
     level_to_bootstrap = ctxt_level_after_bootstrap + options.num_levels;
     unsigned int depth = level_to_bootstrap + 2;
+    live_bytes_by_level = std::vector<std::atomic<long>>(depth + 1);
+    operation_bytes_by_level.assign(operation_memory_samples.size() * (depth + 1), 0);
     parameters.SetMultiplicativeDepth(depth);
 
+    std::stringstream parameters_description;
+    parameters_description << parameters
+                           << "levelBudget: " << levelBudget[0] << "," << levelBudget[1] << std::endl
+                           << "num_levels: " << options.num_levels << std::endl;
+    std::string key_cache_entry;
+    if (!options.key_cache_dirname.empty())
+    {
+      key_cache_entry = get_key_cache_entry(parameters_description.str());
+      if (load_crypto_context(key_cache_entry, parameters_description.str()))
+      {
+        // The bootstrapping precomputations are not serialized with the context.
+        context->EvalBootstrapSetup(levelBudget);
+        return;
+      }
+    }
+
     context = GenCryptoContext(parameters);
 
     context->Enable(PKE);
@@ -322,15 +541,115 @@ void ExecutionEngine::setup_crypto_context()
     key_pair = context->KeyGen();
     context->EvalMultKeyGen(key_pair.secretKey);
     context->EvalBootstrapKeyGen(key_pair.secretKey, numSlots);
+
+    if (!key_cache_entry.empty())
+    {
+      store_crypto_context(key_cache_entry, parameters_description.str());
+    }
   };
-  utl::perform_func_and_print_execution_time(crypto_func, "Setting up crypto context");
+  perform_phase(crypto_func, "Setting up crypto context");
+}
+
+// Entries are named by an FNV-1a hash of the parameters, which does not
+// change between builds.
+std::string ExecutionEngine::get_key_cache_entry(const std::string &parameters_description) const
+{
+  uint64_t hash = 0xcbf29ce484222325;
+  for (unsigned char c : parameters_description)
+  {
+    hash = (hash ^ c) * 0x100000001b3;
+  }
+
+  std::stringstream entry;
+  entry << options.key_cache_dirname << "/" << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return entry.str();
+}
+
+// Returns false when the entry is missing, incomplete, or was stored for
+// other parameters with the same hash.
+bool ExecutionEngine::load_crypto_context(const std::string &entry, const std::string &parameters_description)
+{
+  std::ifstream parameters_file(entry + "/parameters.txt");
+  if (!parameters_file.is_open())
+  {
+    return false;
+  }
+  std::stringstream stored_description;
+  stored_description << parameters_file.rdbuf();
+  if (stored_description.str() != parameters_description)
+  {
+    std::cout << "Key cache entry " << entry << " holds other parameters, generating new keys." << std::endl;
+    return false;
+  }
+
+  // The keys refer to their context, so it is loaded first.
+  std::ifstream mult_key_file(entry + "/key_eval_mult.bin", std::ios::binary);
+  std::ifstream automorphism_key_file(entry + "/key_eval_automorphism.bin", std::ios::binary);
+  bool loaded = lbcrypto::Serial::DeserializeFromFile(entry + "/cryptocontext.bin", context, lbcrypto::SerType::BINARY) &&
+                lbcrypto::Serial::DeserializeFromFile(entry + "/key_public.bin", key_pair.publicKey, lbcrypto::SerType::BINARY) &&
+                lbcrypto::Serial::DeserializeFromFile(entry + "/key_secret.bin", key_pair.secretKey, lbcrypto::SerType::BINARY) &&
+                context->DeserializeEvalMultKey(mult_key_file, lbcrypto::SerType::BINARY) &&
+                context->DeserializeEvalAutomorphismKey(automorphism_key_file, lbcrypto::SerType::BINARY);
+  if (!loaded)
+  {
+    std::cout << "Could not load key cache entry " << entry << ", generating new keys." << std::endl;
+    return false;
+  }
+
+  std::cout << "Loaded crypto context and keys from " << entry << std::endl;
+  return true;
+}
+
+// The entry is written to a temporary directory and then renamed, so runs
+// sharing the cache never see a partial entry. An entry that could not be
+// loaded is replaced.
+void ExecutionEngine::store_crypto_context(const std::string &entry, const std::string &parameters_description) const
+{
+  auto tmp_entry = entry + ".tmp" + std::to_string(getpid());
+  std::error_code error;
+  std::filesystem::create_directories(tmp_entry, error);
+  if (error)
+  {
+    std::cout << "Could not create key cache directory " << tmp_entry << ": " << error.message() << std::endl;
+    return;
+  }
+
+  std::ofstream mult_key_file(tmp_entry + "/key_eval_mult.bin", std::ios::binary);
+  std::ofstream automorphism_key_file(tmp_entry + "/key_eval_automorphism.bin", std::ios::binary);
+  std::ofstream parameters_file(tmp_entry + "/parameters.txt");
+  parameters_file << parameters_description;
+  bool stored = lbcrypto::Serial::SerializeToFile(tmp_entry + "/cryptocontext.bin", context, lbcrypto::SerType::BINARY) &&
+                lbcrypto::Serial::SerializeToFile(tmp_entry + "/key_public.bin", key_pair.publicKey, lbcrypto::SerType::BINARY) &&
+                lbcrypto::Serial::SerializeToFile(tmp_entry + "/key_secret.bin", key_pair.secretKey, lbcrypto::SerType::BINARY) &&
+                context->SerializeEvalMultKey(mult_key_file, lbcrypto::SerType::BINARY) &&
+                context->SerializeEvalAutomorphismKey(automorphism_key_file, lbcrypto::SerType::BINARY);
+  mult_key_file.close();
+  automorphism_key_file.close();
+  parameters_file.close();
+
+  if (stored && parameters_file && mult_key_file && automorphism_key_file)
+  {
+    std::filesystem::rename(tmp_entry, entry, error);
+    if (error)
+    {
+      std::filesystem::remove_all(entry, error);
+      std::filesystem::rename(tmp_entry, entry, error);
+    }
+    if (!error)
+    {
+      std::cout << "Stored crypto context and keys in " << entry << std::endl;
+      return;
+    }
+  }
+  std::cout << "Could not store key cache entry " << entry << std::endl;
+  std::filesystem::remove_all(tmp_entry, error);
 }
 
 void ExecutionEngine::prepare_inputs()
 {
   std::function<void()> encrypt_func = [this]()
   { encrypt_inputs(); };
-  utl::perform_func_and_print_execution_time(encrypt_func, "Encrypting inputs");
+  perform_phase(encrypt_func, "Encrypting inputs");
 
   std::string num_inputs = std::to_string(sched_info.initial_inputs.size());
 
@@ -338,248 +657,564 @@ void ExecutionEngine::prepare_inputs()
   {
     std::function<void()> boot_func = [this]()
     { bootstrap_initial_inputs(); };
-    utl::perform_func_and_print_execution_time(boot_func, "Bootstrapping " + num_inputs + " inputs");
+    perform_phase(boot_func, "Bootstrapping " + num_inputs + " inputs");
   }
 }
 
 void ExecutionEngine::encrypt_inputs()
 {
-  for (const auto &input : sched_info.initial_inputs)
+  for (auto reg : sched_info.initial_inputs)
   {
-    auto value = validation_regs[input.key];
+    auto value = validation_regs[reg];
     std::vector<double> tmp_vec;
     tmp_vec.push_back(value);
     auto tmp_ptxt = context->MakeCKKSPackedPlaintext(tmp_vec);
 
-    if (input.is_ctxt)
+    if (sched_info.reg_is_ctxt[reg])
     {
       auto tmp = context->Encrypt(key_pair.publicKey, tmp_ptxt);
-      ctxt_regs[input.key] = tmp;
+      account_ctxt(tmp, 1);
+      ctxt_regs[reg] = tmp;
     }
     else
     {
-      ptxt_regs[input.key] = tmp_ptxt;
+      ptxt_regs[reg] = tmp_ptxt;
     }
   }
 }
 
 void ExecutionEngine::bootstrap_initial_inputs()
 {
+  std::vector<int> ctxt_inputs;
+  for (auto reg : sched_info.initial_inputs)
+  {
+    if (sched_info.reg_is_ctxt[reg])
+    {
+      ctxt_inputs.push_back(reg);
+    }
+  }
+
 #pragma omp parallel for
-  for (int i = 0; i < (int) ctxt_regs.size(); i++)//Mihailo added casting to solve issue of warnings being treated as errors (comparison of integer expressions of different signedness)
-  {
-    auto it = ctxt_regs.begin();
-    advance(it, i);
-    auto &[_, ctxt] = *it;
-    auto tmp = context->EvalBootstrap(ctxt);
-    map_lock.lock();
-    ctxt = tmp;
+  for (int i = 0; i < (int) ctxt_inputs.size(); i++)//Mihailo added casting to solve issue of warnings being treated as errors (comparison of integer expressions of different signedness)
+  {
+    auto &ctxt = ctxt_regs[ctxt_inputs[i]];
+    account_ctxt(ctxt, -1);
+    ctxt = context->EvalBootstrap(ctxt);
+    account_ctxt(ctxt, 1);
     /* The below code can be commented in for testing
     with ciphertexts at the noise threshold */
     // for (int i = 0; i < options.num_levels; i++)
     // {
     //   ctxt = context->EvalMult(ctxt, ctxt);
     // }
-    map_lock.unlock();
   }
 }
 
 void ExecutionEngine::execute_in_ciphertext()
 {
   std::function<int()> exec_func = [this]()
-  { return execute_schedule(); };
-  num_bootstraps = utl::perform_func_and_print_execution_time(
-      exec_func, "Executing in ciphertext", &execution_time);
+  {
+    if (options.mode == ExecMode::DYNAMIC)
+    {
+      return execute_schedule_dynamically();
+    }
+    return execute_schedule();
+  };
+  num_bootstraps = perform_phase(exec_func, "Executing in ciphertext", &execution_time);
   std::cout << "Number of bootstrap operations: " << num_bootstraps << "." << std::endl;
 }
 
-ExecutionEngine::Ctxt ExecutionEngine::get_ctxt_input(const std::vector<EngineOpInput> &inputs)
+int ExecutionEngine::execute_schedule()
 {
-  map_lock.lock();
-  auto input_ctxt = ctxt_regs[inputs[0].key];
-  map_lock.unlock();
-  return input_ctxt;
+  std::atomic<int> bootstrap_counter = 0;
+  std::function<void(const EngineInstruction &)> execute_func = [this, &bootstrap_counter](const EngineInstruction &instruction)
+  { execute_instruction(instruction, bootstrap_counter); };
+  run_schedule_threads(execute_func);
+  return bootstrap_counter;
 }
 
-std::pair<ExecutionEngine::Ctxt, ExecutionEngine::Ctxt> ExecutionEngine::get_ctxt_ctxt_inputs(const std::vector<EngineOpInput> &inputs)
+int ExecutionEngine::execute_schedule_dynamically()
 {
-  map_lock.lock();
-  auto inputs_pair = std::pair<Ctxt, Ctxt>{ctxt_regs[inputs[0].key], ctxt_regs[inputs[1].key]};
-  map_lock.unlock();
-  return inputs_pair;
-}
+  std::atomic<int> bootstrap_counter = 0;
+  std::atomic<size_t> num_finished = 0;
+  const auto num_instructions = sched_info.instructions.size();
 
-std::pair<ExecutionEngine::Ctxt, ExecutionEngine::Ptxt> ExecutionEngine::get_ctxt_ptxt_inputs(const std::vector<EngineOpInput> &inputs)
-{
-  map_lock.lock();
-  auto inputs_pair = std::pair<Ctxt, Ptxt>{ctxt_regs[inputs[0].key], ptxt_regs[inputs[1].key]};
-  map_lock.unlock();
-  return inputs_pair;
-}
+  for (size_t i = 0; i < num_instructions; i++)
+  {
+    if (unready_inputs[i] == 0)
+    {
+      push_ready_instruction(i);
+    }
+  }
 
-int ExecutionEngine::execute_schedule()
-{
-  const bool ALAP_mode = (options.mode == ExecMode::ALAP);
-  std::atomic<int> bootstrap_counter = 0;
-#pragma omp parallel for
-  for (size_t i = 0; i < sched_info.circuit.size(); i++)
+#pragma omp parallel
   {
-    for (const auto &operation : sched_info.circuit[i])
+    const int worker = omp_get_thread_num();
+    while (num_finished.load() < num_instructions)
     {
-      auto output_key = operation->get_output();
-      auto inputs = operation->get_inputs();
-      handle_input_mutex(inputs[0].key);
-      bool has_2_inputs = (inputs.size() == 2);
-      if (has_2_inputs)
+      auto epoch = work_epoch.load();
+      auto i = pop_or_steal_instruction(worker);
+      if (i < 0)
       {
-        handle_input_mutex(inputs[1].key);
-      }
-      Ctxt result;
-      switch (operation->get_op_type())
-      {
-      case CP_MUL:
-      {
-        const auto [input1, input2] = get_ctxt_ptxt_inputs(inputs);
-        result = context->EvalMult(input1, input2);
-        context->ModReduceInPlace(result);
-      }
-      break;
-      case CC_MUL:
-      {
-        const auto [input1, input2] = get_ctxt_ctxt_inputs(inputs);
-        result = context->EvalMult(input1, input2);
-        context->ModReduceInPlace(result);
-        break;
-      }
-      case CP_ADD:
-      {
-        const auto [input1, input2] = get_ctxt_ptxt_inputs(inputs);
-        result = context->EvalAdd(input1, ptxt_regs[inputs[1].key]);
-        break;
+        work_epoch.wait(epoch);
+        continue;
       }
-      case CC_ADD:
+
+      const auto &instruction = sched_info.instructions[i];
+      set_trace_wait_start(trace_ready_times.empty() ? 0 : trace_ready_times[i]);
+      execute_instruction(instruction, bootstrap_counter);
+      for (auto consumer : reg_consumers[instruction.output_reg])
       {
-        const auto [input1, input2] = get_ctxt_ctxt_inputs(inputs);
-        result = context->EvalAdd(input1, input2);
-        break;
+        if (--unready_inputs[consumer] == 0)
+        {
+          push_ready_instruction(consumer);
+        }
       }
-      case CP_SUB:
+
+      if (++num_finished == num_instructions)
       {
-        const auto [input1, input2] = get_ctxt_ptxt_inputs(inputs);
-        result = context->EvalSub(input1, ptxt_regs[inputs[1].key]);
-        break;
+        work_epoch++;
+        work_epoch.notify_all();
       }
-      case PC_SUB:
+    }
+  }
+  return bootstrap_counter;
+}
+
+void ExecutionEngine::push_ready_instruction(int i)
+{
+  // Ready instructions go to the worker of their scheduled thread and are
+  // kept in schedule order, so the static schedule is the first choice.
+  auto &queue = worker_queues[sched_info.instructions[i].thread_idx % worker_queues.size()];
+  if (options.trace)
+  {
+    trace_ready_times[i] = get_trace_time();
+  }
+  queue.lock.lock();
+  queue.instructions.insert(
+      std::upper_bound(queue.instructions.begin(), queue.instructions.end(), i), i);
+  queue.lock.unlock();
+
+  work_epoch++;
+  work_epoch.notify_all();
+}
+
+int ExecutionEngine::pop_or_steal_instruction(int worker)
+{
+  // Workers take the earliest instruction of their own queue and steal the
+  // latest instruction of another queue.
+  const int num_workers = worker_queues.size();
+  for (int k = 0; k < num_workers; k++)
+  {
+    auto &queue = worker_queues[(worker + k) % num_workers];
+    int i = -1;
+    queue.lock.lock();
+    if (!queue.instructions.empty())
+    {
+      if (k == 0)
       {
-        const auto [input1, input2] = get_ctxt_ptxt_inputs(inputs);
-        result = context->EvalSub(input1, ptxt_regs[inputs[1].key]);
-        result = context->EvalNegate(result);
+        i = queue.instructions.front();
+        queue.instructions.pop_front();
       }
-      case CC_SUB:
+      else
       {
-        const auto [input1, input2] = get_ctxt_ctxt_inputs(inputs);
-        result = context->EvalSub(input1, input2);
-        break;
+        i = queue.instructions.back();
+        queue.instructions.pop_back();
       }
-      case INV:
+    }
+    queue.lock.unlock();
+    if (i >= 0)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void ExecutionEngine::execute_instruction(const EngineInstruction &instruction, std::atomic<int> &bootstrap_counter)
+{
+  const auto &inputs = instruction.input_regs;
+  const auto output_reg = instruction.output_reg;
+  auto start_time = get_trace_time();
+  Ctxt result;
+  if (instruction.in_place)
+  {
+    result = std::move(ctxt_regs[inputs[0]]);
+    account_ctxt(result, -1);
+    evaluate_in_place(instruction, result);
+  }
+  else
+  {
+    result = evaluate(instruction, bootstrap_counter);
+  }
+
+  if (options.mode == ExecMode::ALAP &&
+      sched_info.bootstrap_candidates[output_reg] &&
+      result->GetLevel() >= (long unsigned int) level_to_bootstrap)//Mihailo added casting to solve issue of warnings being treated as errors (comparison of integer expressions of different signedness)
+  {
+    result = context->EvalBootstrap(result);
+    bootstrap_counter++;
+  }
+
+  if (options.trace)
+  {
+    record_trace_event(instruction, start_time, result->GetLevel());
+  }
+
+  account_ctxt(result, 1);
+  ctxt_regs[output_reg] = std::move(result);
+
+  mark_ready(output_reg);
+
+  release_inputs(instruction);
+
+  if (options.memory_profile)
+  {
+    record_operation_memory_sample(output_reg);
+  }
+}
+
+ExecutionEngine::Ctxt ExecutionEngine::evaluate(const EngineInstruction &instruction, std::atomic<int> &bootstrap_counter)
+{
+  const auto &inputs = instruction.input_regs;
+  Ctxt result;
+  switch (instruction.op_type)
+  {
+  case CP_MUL:
+    result = context->EvalMult(ctxt_regs[inputs[0]], ptxt_regs[inputs[1]]);
+    context->ModReduceInPlace(result);
+    break;
+  case CC_MUL:
+    result = context->EvalMult(ctxt_regs[inputs[0]], ctxt_regs[inputs[1]]);
+    context->ModReduceInPlace(result);
+    break;
+  case CP_ADD:
+    result = context->EvalAdd(ctxt_regs[inputs[0]], ptxt_regs[inputs[1]]);
+    break;
+  case CC_ADD:
+    result = context->EvalAdd(ctxt_regs[inputs[0]], ctxt_regs[inputs[1]]);
+    break;
+  case CP_SUB:
+    result = context->EvalSub(ctxt_regs[inputs[0]], ptxt_regs[inputs[1]]);
+    break;
+  case PC_SUB:
+    result = context->EvalSub(ctxt_regs[inputs[0]], ptxt_regs[inputs[1]]);
+    result = context->EvalNegate(result);
+    break;
+  case CC_SUB:
+    result = context->EvalSub(ctxt_regs[inputs[0]], ctxt_regs[inputs[1]]);
+    break;
+  case INV:
+    result = context->EvalNegate(ctxt_regs[inputs[0]]);
+    break;
+  case BOOT:
+    result = context->EvalBootstrap(ctxt_regs[inputs[0]]);
+    bootstrap_counter++;
+    break;
+  default:
+    std::cout << "Invalid Instruction! Exiting..." << std::endl;
+    exit(-1);
+  }
+  return result;
+}
+
+void ExecutionEngine::evaluate_in_place(const EngineInstruction &instruction, Ctxt &result)
+{
+  const auto &inputs = instruction.input_regs;
+  switch (instruction.op_type)
+  {
+  case CP_ADD:
+    context->EvalAddInPlace(result, ptxt_regs[inputs[1]]);
+    break;
+  case CC_ADD:
+    context->EvalAddInPlace(result, ctxt_regs[inputs[1]]);
+    break;
+  case CP_SUB:
+    context->EvalSubInPlace(result, ptxt_regs[inputs[1]]);
+    break;
+  case PC_SUB:
+    context->EvalSubInPlace(result, ptxt_regs[inputs[1]]);
+    context->EvalNegateInPlace(result);
+    break;
+  case CC_SUB:
+    context->EvalSubInPlace(result, ctxt_regs[inputs[1]]);
+    break;
+  case INV:
+    context->EvalNegateInPlace(result);
+    break;
+  default:
+    std::cout << "Invalid in-place Instruction! Exiting..." << std::endl;
+    exit(-1);
+  }
+}
+
+void ExecutionEngine::release_inputs(const EngineInstruction &instruction)
+{
+  for (int j = 0; j < instruction.num_inputs; j++)
+  {
+    auto reg = instruction.input_regs[j];
+    switch (instruction.input_releases[j])
+    {
+    case RegRelease::KEEP:
+      break;
+    case RegRelease::DECREMENT:
+      if (remaining_uses[reg].fetch_sub(1, std::memory_order_acq_rel) != 1)
       {
-        const auto input1 = get_ctxt_input(inputs);
-        result = context->EvalNegate(input1);
         break;
       }
-      case BOOT:
+      [[fallthrough]];
+    case RegRelease::FREE:
+      if (sched_info.reg_is_ctxt[reg])
       {
-        const auto input1 = get_ctxt_input(inputs);
-        result = context->EvalBootstrap(input1);
-        bootstrap_counter++;
-        break;
+        account_ctxt(ctxt_regs[reg], -1);
+        ctxt_regs[reg] = nullptr;
       }
-      default:
-        std::cout << "Invalid Instruction! Exiting..." << std::endl;
-        exit(-1);
-      }
-      if (ALAP_mode &&
-          sched_info.bootstrap_candidates.count(output_key) &&
-          result->GetLevel() >= (long unsigned int) level_to_bootstrap)//Mihailo added casting to solve issue of warnings being treated as errors (comparison of integer expressions of different signedness)
+      else
       {
-        result = context->EvalBootstrap(result);
-        bootstrap_counter++;
+        ptxt_regs[reg] = nullptr;
       }
+      break;
+    }
+  }
+}
+
+void ExecutionEngine::account_ctxt(const Ctxt &ctxt, long sign)
+{
+  if (!options.memory_profile || !ctxt)
+  {
+    return;
+  }
+  const auto &elements = ctxt->GetElements();
+  long bytes = elements.size() * elements[0].GetNumOfElements() * elements[0].GetRingDimension() * sizeof(uint64_t);
+  auto level = std::min<size_t>(ctxt->GetLevel(), live_bytes_by_level.size() - 1);
+  live_ctxts += sign;
+  live_bytes_by_level[level] += sign * bytes;
+}
+
+void ExecutionEngine::record_memory_sample(const std::string &event, std::vector<MemorySample> &samples)
+{
+  MemorySample sample;
+  sample.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - engine_start_time).count();
+  sample.thread = omp_get_thread_num();
+  sample.event = event;
+  sample.live_ctxts = live_ctxts.load(std::memory_order_relaxed);
+  for (const auto &bytes : live_bytes_by_level)
+  {
+    sample.bytes_by_level.push_back(bytes.load(std::memory_order_relaxed));
+  }
 
-      map_lock.lock();
-      ctxt_regs[output_key] = result;
-      map_lock.unlock();
+  // Linux reports memory for the whole process, not for single threads.
+  std::ifstream statm("/proc/self/statm");
+  long size_pages = 0;
+  long resident_pages = 0;
+  statm >> size_pages >> resident_pages;
+  sample.rss_kb = resident_pages * (sysconf(_SC_PAGESIZE) / 1024);
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  sample.peak_rss_kb = usage.ru_maxrss;
+
+  samples.push_back(std::move(sample));
+}
 
-      reg_locks[output_key]->unlock();
+void ExecutionEngine::record_operation_memory_sample(int reg)
+{
+  auto &sample = operation_memory_samples[reg];
+  sample.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - engine_start_time).count();
+  sample.thread = omp_get_thread_num();
+  sample.live_ctxts = live_ctxts.load(std::memory_order_relaxed);
 
-      // std::cout << output_key << " level: " << result->GetLevel() << std::endl;
-      // if (result->GetLevel() == 0)
-      // {
-      //   std::cout << inputs[0].key << " level: " << ctxt_regs[inputs[0].key]->GetLevel() << std::endl;
-      //   if (has_2_inputs)
-      //   {
-      //     std::cout << inputs[1].key << " level: " << ctxt_regs[inputs[1].key]->GetLevel() << std::endl;
-      //   }
-      // }
+  const auto num_levels = live_bytes_by_level.size();
+  for (size_t level = 0; level < num_levels; level++)
+  {
+    operation_bytes_by_level[reg * num_levels + level] = live_bytes_by_level[level].load(std::memory_order_relaxed);
+  }
+}
 
-      update_dependence_info(inputs[0], output_key);
-      if (has_2_inputs)
+void ExecutionEngine::generate_trace_buffers()
+{
+  if (!options.trace)
+  {
+    return;
+  }
+  trace_buffers = std::vector<TraceBuffer>(get_num_workers());
+  for (auto &buffer : trace_buffers)
+  {
+    buffer.events.resize(trace_buffer_capacity);
+  }
+  if (options.mode == ExecMode::DYNAMIC)
+  {
+    trace_ready_times.assign(sched_info.instructions.size(), 0);
+  }
+}
+
+int64_t ExecutionEngine::get_trace_time() const
+{
+  if (!options.trace)
+  {
+    return 0;
+  }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - engine_start_time).count();
+}
+
+void ExecutionEngine::set_trace_wait_start(int64_t wait_start)
+{
+  if (options.trace)
+  {
+    trace_buffers[omp_get_thread_num()].wait_start = wait_start;
+  }
+}
+
+void ExecutionEngine::record_trace_event(const EngineInstruction &instruction, int64_t start_time, size_t level)
+{
+  auto &buffer = trace_buffers[omp_get_thread_num()];
+  auto &event = buffer.events[buffer.num_recorded % trace_buffer_capacity];
+  event.instruction = &instruction - sched_info.instructions.data();
+  event.wait_start = std::min(buffer.wait_start, start_time);
+  event.start = start_time;
+  event.end = get_trace_time();
+  event.level = level;
+  buffer.num_recorded++;
+}
+
+void ExecutionEngine::write_trace() const
+{
+  // Chrome trace-event format, viewable in chrome://tracing or Perfetto.
+  // Times are in microseconds since the engine started.
+  std::ofstream trace_file(options.trace_filename);
+  trace_file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::endl;
+  bool first = true;
+  auto write_separator = [&]()
+  {
+    trace_file << (first ? "" : ",\n");
+    first = false;
+  };
+
+  for (size_t worker = 0; worker < trace_buffers.size(); worker++)
+  {
+    write_separator();
+    trace_file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << worker
+               << ", \"args\": {\"name\": \"worker " << worker << "\"}}";
+
+    const auto &buffer = trace_buffers[worker];
+    auto num_kept = std::min(buffer.num_recorded, trace_buffer_capacity);
+    if (num_kept < buffer.num_recorded)
+    {
+      std::cout << "Trace of worker " << worker << " kept the last " << num_kept << " of "
+                << buffer.num_recorded << " operations." << std::endl;
+    }
+    for (size_t k = buffer.num_recorded - num_kept; k < buffer.num_recorded; k++)
+    {
+      const auto &event = buffer.events[k % trace_buffer_capacity];
+      const auto &instruction = sched_info.instructions[event.instruction];
+      const auto &output_key = sched_info.reg_keys[instruction.output_reg];
+      if (event.start > event.wait_start)
       {
-        update_dependence_info(inputs[1], output_key);
+        write_separator();
+        trace_file << "{\"name\": \"wait " << output_key << "\", \"cat\": \"wait\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << worker
+                   << ", \"ts\": " << event.wait_start / 1000.0 << ", \"dur\": " << (event.start - event.wait_start) / 1000.0 << "}";
       }
+      write_separator();
+      trace_file << "{\"name\": \"" << get_op_type_name(instruction.op_type) << " " << output_key
+                 << "\", \"cat\": \"" << get_op_type_name(instruction.op_type) << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << worker
+                 << ", \"ts\": " << event.start / 1000.0 << ", \"dur\": " << (event.end - event.start) / 1000.0
+                 << ", \"args\": {\"output\": \"" << output_key << "\", \"scheduled_thread\": " << instruction.thread_idx + 1
+                 << ", \"level\": " << event.level << ", \"wait_us\": " << (event.start - event.wait_start) / 1000.0 << "}}";
     }
   }
-  return bootstrap_counter;
+  trace_file << std::endl
+             << "]}" << std::endl;
+  trace_file.close();
 }
 
-void ExecutionEngine::update_dependence_info(const EngineOpInput &input, const std::string &output_key)
+void ExecutionEngine::write_memory_profile() const
 {
-  const auto &input_key = input.key;
-  dependence_locks[input_key]->lock();
-  map_lock.lock();
-  sched_info.dependent_outputs[input_key].erase(output_key);
-  if (sched_info.dependent_outputs[input_key].empty())
+  // Operation samples have no RSS, which is marked by -1.
+  std::vector<MemorySample> samples = memory_phase_samples;
+  const auto num_levels = live_bytes_by_level.size();
+  for (size_t reg = 0; reg < operation_memory_samples.size(); reg++)
   {
-    if (input.is_ctxt)
+    const auto &operation_sample = operation_memory_samples[reg];
+    if (operation_sample.time < 0)
     {
-      ctxt_regs.erase(input_key);
-      // reg_locks.erase(input_key);
+      continue;
+    }
+    auto bytes_begin = operation_bytes_by_level.begin() + reg * num_levels;
+    samples.push_back({operation_sample.time / 1e9,
+                       operation_sample.thread,
+                       sched_info.reg_keys[reg],
+                       operation_sample.live_ctxts,
+                       std::vector<long>(bytes_begin, bytes_begin + num_levels),
+                       -1,
+                       -1});
+  }
+  std::stable_sort(samples.begin(), samples.end(), [](const MemorySample &a, const MemorySample &b)
+                   { return a.time < b.time; });
+
+  std::ofstream memory_file(options.memory_profile_filename);
+  memory_file << "time,thread,event,live_ctxts,live_bytes,rss_kb,peak_rss_kb";
+  for (size_t level = 0; level < live_bytes_by_level.size(); level++)
+  {
+    memory_file << ",bytes_level_" << level;
+  }
+  memory_file << std::endl;
+
+  for (const auto &sample : samples)
+  {
+    long live_bytes = 0;
+    for (auto bytes : sample.bytes_by_level)
+    {
+      live_bytes += bytes;
+    }
+    memory_file << sample.time << "," << sample.thread << "," << sample.event << "," << sample.live_ctxts << ","
+                << live_bytes << ",";
+    if (sample.rss_kb >= 0)
+    {
+      memory_file << sample.rss_kb << "," << sample.peak_rss_kb;
     }
     else
     {
-      ptxt_regs.erase(input_key);
+      memory_file << ",";
     }
+    for (size_t level = 0; level < live_bytes_by_level.size(); level++)
+    {
+      memory_file << "," << (level < sample.bytes_by_level.size() ? sample.bytes_by_level[level] : 0);
+    }
+    memory_file << std::endl;
   }
-  map_lock.unlock();
-  dependence_locks[input_key]->unlock();
+  memory_file.close();
 }
 
 void ExecutionEngine::verify_results()
 {
   std::function<void()> validate_func = [this]()
   { validate_results(); };
-  utl::perform_func_and_print_execution_time(
-      validate_func, "Comparing ctxt results against ptxt results");
+  perform_phase(validate_func, "Comparing ctxt results against ptxt results");
 }
 
 void ExecutionEngine::validate_results() const
 {
   const double error_threshold = 0.5;
 
-  for (const auto &[key, ctxt] : ctxt_regs)
+  for (size_t reg = 0; reg < ctxt_regs.size(); reg++)
   {
+    const auto &ctxt = ctxt_regs[reg];
+    if (!ctxt)
+    {
+      continue;
+    }
+    const auto &key = sched_info.reg_keys[reg];
     Ptxt tmp_ptxt;
     context->Decrypt(key_pair.secretKey, ctxt, &tmp_ptxt);
     auto decrypted_val = tmp_ptxt->GetRealPackedValue()[0];
 
-    auto percent_error = utl::get_percent_error(decrypted_val, validation_regs.at(key));
+    auto percent_error = utl::get_percent_error(decrypted_val, validation_regs[reg]);
     if (percent_error > error_threshold)
     {
       std::cout << "WARNING!" << std::endl;
       std::cout << "WARNING!" << std::endl;
       std::cout << "The following result has an error greater than the threshold of " << error_threshold << "%." << std::endl;
     }
-    std::cout << key << ": FHE result: " << decrypted_val << ", expected: " << validation_regs.at(key) << ", error: " << percent_error << "%" << std::endl;
+    std::cout << key << ": FHE result: " << decrypted_val << ", expected: " << validation_regs[reg] << ", error: " << percent_error << "%" << std::endl;
   }
 }
 
@@ -597,22 +1232,154 @@ void ExecutionEngine::write_execution_info_to_files()
     segments_file << num_bootstraps << std::endl;
     segments_file.close();
   }
+  if (options.memory_profile)
+  {
+    write_memory_profile();
+  }
+  if (options.trace)
+  {
+    write_trace();
+  }
+}
+
+void ExecutionEngine::calibrate_latencies()
+{
+  std::function<void()> calibrate_func = [this]()
+  { measure_latencies(); };
+  perform_phase(calibrate_func, "Measuring operation latencies");
+
+  write_latency_file();
+}
+
+void ExecutionEngine::measure_latencies()
+{
+  // Levels are counted as in the schedulers: a bootstrapped ciphertext has
+  // num_levels levels left, and each multiplication uses one.
+  measured_latencies.clear();
+  for (int levels = 0; levels <= options.num_levels; levels++)
+  {
+    auto input1 = get_calibration_ctxt(levels);
+    auto input2 = get_calibration_ctxt(levels);
+    Ctxt result;
+
+    std::function<void()> add_func = [&]()
+    { result = context->EvalAdd(input1, input2); };
+    std::function<void()> sub_func = [&]()
+    { result = context->EvalSub(input1, input2); };
+    std::function<void()> mul_func = [&]()
+    {
+      result = context->EvalMult(input1, input2);
+      context->ModReduceInPlace(result);
+    };
+    std::function<void()> boot_func = [&]()
+    { result = context->EvalBootstrap(input1); };
+
+    measured_latencies["ADD"].push_back(time_operation(add_func));
+    measured_latencies["SUB"].push_back(time_operation(sub_func));
+    measured_latencies["MUL"].push_back(time_operation(mul_func));
+    measured_latencies["BOOT"].push_back(time_operation(boot_func));
+
+    std::cout << "Levels " << levels << ":";
+    for (const auto &type : latency_types)
+    {
+      std::cout << " " << type << " " << measured_latencies[type].back() << " us";
+    }
+    std::cout << std::endl;
+  }
+}
+
+ExecutionEngine::Ctxt ExecutionEngine::get_calibration_ctxt(int levels)
+{
+  auto ptxt = context->MakeCKKSPackedPlaintext(std::vector<double>{options.inputs_value});
+  auto ctxt = context->EvalBootstrap(context->Encrypt(key_pair.publicKey, ptxt));
+  for (int i = levels; i < options.num_levels; i++)
+  {
+    ctxt = context->EvalMult(ctxt, ptxt);
+    context->ModReduceInPlace(ctxt);
+  }
+  return ctxt;
+}
+
+double ExecutionEngine::time_operation(const std::function<void()> &func) const
+{
+  // Returns the median time in microseconds.
+  for (int i = 0; i < options.calibration_warmups; i++)
+  {
+    func();
+  }
+
+  std::vector<double> times;
+  for (int i = 0; i < options.calibration_repetitions; i++)
+  {
+    auto t1 = std::chrono::steady_clock::now();
+    func();
+    auto t2 = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double, std::micro>(t2 - t1).count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+void ExecutionEngine::write_latency_file()
+{
+  auto get_mean = [](const std::vector<double> &values)
+  {
+    return std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+  };
+
+  // The schedulers step through time one unit at a time, so the latencies
+  // are written in units of the latency of an ADD unless a unit is given.
+  auto unit = options.latency_unit > 0 ? options.latency_unit : get_mean(measured_latencies.at("ADD"));
+  auto to_units = [unit](double latency)
+  {
+    return std::max(1, static_cast<int>(std::lround(latency / unit)));
+  };
+
+  std::ofstream latency_file(options.latency_filename);
+  for (const auto &type : latency_types)
+  {
+    latency_file << type << "," << to_units(get_mean(measured_latencies.at(type))) << std::endl;
+  }
+  if (options.level_resolved_latencies)
+  {
+    for (const auto &type : latency_types)
+    {
+      const auto &latencies = measured_latencies.at(type);
+      for (size_t levels = 0; levels < latencies.size(); levels++)
+      {
+        latency_file << type << "," << levels << "," << to_units(latencies[levels]) << std::endl;
+      }
+    }
+  }
+  latency_file.close();
+
+  std::cout << "Latencies written to " << options.latency_filename << " in units of " << unit << " us." << std::endl;
 }
 
 void ExecutionEngine::print_schedule() const
 {
-  int i = 0;
-  for (const auto &core_schedule : sched_info.circuit)
+  for (size_t t = 0; t < sched_info.get_num_threads(); t++)
   {
-    std::cout << "=== Nodes for Worker " << i << " ===" << std::endl;
-    for (const auto &operation : core_schedule)
+    std::cout << "=== Nodes for Worker " << t << " ===" << std::endl;
+    for (size_t i = sched_info.thread_offsets[t]; i < sched_info.thread_offsets[t + 1]; i++)
     {
-      operation->print();
+      print_instruction(sched_info.instructions[i]);
     }
-    i++;
   }
 }
 
+void ExecutionEngine::print_instruction(const EngineInstruction &instruction) const
+{
+  std::cout << "Op: " << instruction.op_type << std::endl;
+  std::cout << "Input(s): ";
+  for (int i = 0; i < instruction.num_inputs; i++)
+  {
+    std::cout << sched_info.reg_keys[instruction.input_regs[i]] << " ";
+  }
+  std::cout << std::endl;
+  std::cout << "Output: " << sched_info.reg_keys[instruction.output_reg] << std::endl;
+}
+
 void ExecutionEngine::parse_args(int argc, char **argv)
 {
   const int minimum_arguments = 2;
@@ -690,11 +1457,59 @@ void ExecutionEngine::parse_args(int argc, char **argv)
   {
     options.mode = ExecMode::PLAINTEXT;
   }
+  else if (options.mode_string == "CALIBRATE")
+  {
+    options.mode = ExecMode::CALIBRATE;
+    options.latency_filename = sched_filename_no_ext + "_latencies.txt";
+  }
+  else if (options.mode_string == "DYNAMIC")
+  {
+    options.mode = ExecMode::DYNAMIC;
+  }
   else
   {
     throw std::invalid_argument(options.mode_string + "is not a valid execution mode.");
   }
 
+  auto num_workers_string = utl::get_arg(options_string, "-w", "--num-workers", help_info);
+  if (!num_workers_string.empty())
+  {
+    options.num_workers = stoi(num_workers_string);
+  }
+
+  auto repetitions_string = utl::get_arg(options_string, "-n", "--repetitions", help_info);
+  if (!repetitions_string.empty())
+  {
+    options.calibration_repetitions = stoi(repetitions_string);
+    if (options.calibration_repetitions < 1)
+    {
+      throw std::invalid_argument(repetitions_string + " is not a valid number of repetitions, it must be at least 1.");
+    }
+  }
+
+  auto warmups_string = utl::get_arg(options_string, "-W", "--warmups", help_info);
+  if (!warmups_string.empty())
+  {
+    options.calibration_warmups = stoi(warmups_string);
+    if (options.calibration_warmups < 0)
+    {
+      throw std::invalid_argument(warmups_string + " is not a valid number of warmups, it must be at least 0.");
+    }
+  }
+
+  auto latency_unit_string = utl::get_arg(options_string, "-U", "--latency-unit", help_info);
+  if (!latency_unit_string.empty())
+  {
+    options.latency_unit = stod(latency_unit_string);
+  }
+
+  if (utl::arg_exists(options_string, "-R", "--level-resolved"))
+  {
+    options.level_resolved_latencies = true;
+  }
+
+  options.key_cache_dirname = utl::get_arg(options_string, "-k", "--key-cache", help_info);
+
   if (utl::arg_exists(options_string, "-v", "--verify"))
   {
     options.verify_results = true;
@@ -715,6 +1530,28 @@ void ExecutionEngine::parse_args(int argc, char **argv)
   {
     options.num_bootstraps_filename = sched_filename_no_ext + "_num_bootstraps_" + options.mode_string + ".txt";
   }
+
+  if (utl::arg_exists(options_string, "-p", "--memory-profile"))
+  {
+    options.memory_profile = true;
+    options.memory_profile_filename = sched_filename_no_ext + "_memory_" + options.mode_string;
+    if (!output_suffix.empty())
+    {
+      options.memory_profile_filename += "_" + output_suffix;
+    }
+    options.memory_profile_filename += ".csv";
+  }
+
+  if (utl::arg_exists(options_string, "-t", "--trace"))
+  {
+    options.trace = true;
+    options.trace_filename = sched_filename_no_ext + "_trace_" + options.mode_string;
+    if (!output_suffix.empty())
+    {
+      options.trace_filename += "_" + output_suffix;
+    }
+    options.trace_filename += ".json";
+  }
 }
 
 void ExecutionEngine::print_options() const
@@ -735,11 +1572,23 @@ void ExecutionEngine::print_options() const
     break;
   }
   std::cout << "mode: " << options.mode_string << std::endl;
+  std::cout << "num_workers: " << (options.num_workers > 0 ? std::to_string(options.num_workers) : "one per scheduled thread") << std::endl;
   std::cout << "verify_results: " << (options.verify_results ? "yes" : "no") << std::endl;
   std::cout << "bootstrap_inputs: " << (options.bootstrap_inputs ? "yes" : "no") << std::endl;
   std::cout << "sched_filename: " << options.sched_filename << std::endl;
   std::cout << "eval_time_filename: " << options.eval_time_filename << std::endl;
   std::cout << "num_bootstraps_filename: " << options.num_bootstraps_filename << std::endl;
+  std::cout << "memory_profile_filename: " << options.memory_profile_filename << std::endl;
+  std::cout << "trace_filename: " << options.trace_filename << std::endl;
+  std::cout << "key_cache_dirname: " << (options.key_cache_dirname.empty() ? "none" : options.key_cache_dirname) << std::endl;
+  if (options.mode == ExecMode::CALIBRATE)
+  {
+    std::cout << "latency_filename: " << options.latency_filename << std::endl;
+    std::cout << "calibration_repetitions: " << options.calibration_repetitions << std::endl;
+    std::cout << "calibration_warmups: " << options.calibration_warmups << std::endl;
+    std::cout << "latency_unit: " << (options.latency_unit > 0 ? std::to_string(options.latency_unit) + " us" : "ADD") << std::endl;
+    std::cout << "level_resolved_latencies: " << (options.level_resolved_latencies ? "yes" : "no") << std::endl;
+  }
 }
 
 int main(int argc, char **argv)
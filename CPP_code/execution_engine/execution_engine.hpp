@@ -1,4 +1,5 @@
 #include <map>
+#include <vector>
 #include <cstdlib>
 #include <ctime>
 #include <ratio>
@@ -7,11 +8,24 @@
 #include <memory>
 #include <unordered_set>
 #include <atomic>
+#include <deque>
+#include <algorithm>
+#include <coroutine>
+#include <functional>
+#include <type_traits>
+#include <numeric>
+#include <sys/resource.h>
+#include <unistd.h>
 #include <stdexcept>
+#include <filesystem>
+#include <iomanip>
 #include "omp.h"
 
 #include "schedule_parser.hpp"
 #include "openfhe.h"
+#include "cryptocontext-ser.h"
+#include "key/key-ser.h"
+#include "scheme/ckksrns/ckksrns-ser.h"
 
 class ExecutionEngine
 {
@@ -42,10 +56,33 @@ Options:
       FILE: Inputs are provided by a file. The file has one input per line, with the format <key>,<number>.
         Keys are checked to match the provided schedule. Value is the filename.
   -m <mode>, --mode=<mode>
-    The execution mode. There are three possible options, of which BOOSTER is the default.
+    The execution mode. There are five possible options, of which BOOSTER is the default.
       BOOSTER: Standard execution mode, with all operation types supported.
+      DYNAMIC: Like BOOSTER, but operations run as soon as their inputs are ready. Each scheduled thread
+        keeps its ready operations in schedule order, and idle threads steal from the others.
       PLAINTEXT: Performs the schedule in the plaintext domain, printing output values at the end.
       ALAP: BOOT operations not allowed. Bootstrapping is performed dynamically, as late as possible.
+      CALIBRATE: No schedule is run. Each operation type is timed on a ciphertext with every number of levels
+        left, from 0 to the number of levels, and the latencies are written to \"<sched_file>_latencies.txt\"
+        in the format of the -l option of the schedulers.
+  -n <int>, --repetitions=<int>
+    In CALIBRATE mode, the number of timed runs of each operation. The median is used. Defaults to 10.
+  -W <int>, --warmups=<int>
+    In CALIBRATE mode, the number of untimed runs before the timed ones. Defaults to 2.
+  -U <float>, --latency-unit=<float>
+    In CALIBRATE mode, the length in microseconds of one latency unit in the written file.
+    Defaults to the mean latency of an ADD, so that ADD has latency 1.
+  -R, --level-resolved
+    In CALIBRATE mode, also writes one line <type>,<levels>,<latency> per operation type and number of levels left.
+  -w <int>, --num-workers=<int>
+    The number of OS threads that execute the schedule. When set, each scheduled thread runs as a coroutine
+    that suspends while its inputs are not ready, so schedules for more cores than the host has do not
+    oversubscribe it. Defaults to one OS thread per scheduled thread.
+  -k <dir>, --key-cache=<dir>
+    A directory that caches the crypto context and keys between runs. Each set of parameters (ring dimension,
+    depth, level budget, and number of levels) gets a subdirectory named by a hash of the parameters. The context
+    and keys are loaded from it when present, and generated and stored in it otherwise. The secret key is stored
+    as well. Defaults to no cache.
   -v, --verify
     Decrypts the results from the encrypted domain, and compares to expected values. Ignored if mode=PLAINTEXT.
   -b, --bootstrap-inputs
@@ -53,7 +90,16 @@ Options:
   -o <string>, --output-suffix=<string>
     A file named \"<sched_file>_eval_time_<mode>_<string>.txt\" stores the evaluation time of the schedule.
   -s, --save-num-bootstraps
-    A file named \"<sched_file>_num_bootstraps_<mode>.txt\" stores the number of the bootstraps performed executing the schedule.)";
+    A file named \"<sched_file>_num_bootstraps_<mode>.txt\" stores the number of the bootstraps performed executing the schedule.
+  -p, --memory-profile
+    A file named \"<sched_file>_memory_<mode>[_<string>].csv\" stores a time series of the live ciphertexts and their
+    estimated bytes by level. There is a row after each operation, tagged with the worker and output key, and one
+    after each timed step, which also holds the current and peak RSS of the process. <string> is the output suffix,
+    if any. Ignored if mode=PLAINTEXT.
+  -t, --trace
+    A file named \"<sched_file>_trace_<mode>[_<string>].json\" stores every operation of the ciphertext execution in
+    Chrome trace-event format, one track per worker, with its start and end, opcode, output key, level, and the time
+    spent waiting for its inputs. Each worker keeps its last 65536 operations. Ignored if mode=PLAINTEXT.)";
 
   CommandLineOptions options;
 
@@ -63,12 +109,121 @@ Options:
 
   int level_to_bootstrap;
 
-  std::map<std::string, Ctxt> ctxt_regs;
-  std::map<std::string, Ptxt> ptxt_regs;
-  std::map<std::string, double> validation_regs;
-  std::map<std::string, std::unique_ptr<std::mutex>> reg_locks;
-  std::map<std::string, std::unique_ptr<std::mutex>> dependence_locks;
-  std::mutex map_lock;
+  // How many times a consumer polls an input's ready flag before it
+  // blocks on it.
+  static constexpr int ready_spin_iterations = 2048;
+
+  // Indexed by register id. Each slot is written once by the thread that
+  // produces it, so the vectors are sized up front and need no global lock.
+  std::vector<Ctxt> ctxt_regs;
+  std::vector<Ptxt> ptxt_regs;
+  std::vector<double> validation_regs;
+  std::vector<std::atomic<bool>> reg_ready;
+  // The uses left of each register released with RegRelease::DECREMENT.
+  std::vector<std::atomic<int>> remaining_uses;
+
+  // The task graph of DYNAMIC mode. Instructions are indexed by their
+  // position in sched_info.instructions.
+  struct WorkerQueue
+  {
+    std::mutex lock;
+    std::deque<int> instructions;
+  };
+  std::vector<std::atomic<int>> unready_inputs;
+  std::vector<std::vector<int>> reg_consumers;
+  std::vector<WorkerQueue> worker_queues;
+  // Bumped whenever an instruction becomes ready, so idle workers can wait on it.
+  std::atomic<int> work_epoch;
+
+  // With --num-workers, every scheduled thread is a coroutine that the
+  // workers resume from runnable_threads. A coroutine waiting on a register
+  // is kept in reg_waiters until mark_ready moves it back.
+  struct ScheduleThread
+  {
+    struct promise_type
+    {
+      ScheduleThread get_return_object()
+      {
+        return {std::coroutine_handle<promise_type>::from_promise(*this)};
+      }
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      std::suspend_always final_suspend() noexcept { return {}; }
+      void return_void() {}
+      void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+  };
+
+  struct RegisterAwaiter
+  {
+    ExecutionEngine *engine;
+    int reg;
+
+    bool await_ready() const;
+    bool await_suspend(std::coroutine_handle<>) const;
+    void await_resume() const {}
+  };
+
+  std::vector<std::mutex> reg_waiter_locks;
+  std::vector<std::vector<std::coroutine_handle<>>> reg_waiters;
+  std::deque<std::coroutine_handle<>> runnable_threads;
+  std::mutex runnable_lock;
+
+  struct MemorySample
+  {
+    double time;
+    int thread;
+    std::string event;
+    long live_ctxts;
+    std::vector<long> bytes_by_level;
+    long rss_kb;
+    long peak_rss_kb;
+  };
+  std::chrono::steady_clock::time_point engine_start_time;
+  std::atomic<long> live_ctxts = 0;
+  std::vector<std::atomic<long>> live_bytes_by_level;
+  // Samples taken after each timed step.
+  std::vector<MemorySample> memory_phase_samples;
+  // Samples taken after each operation. They are indexed by output register,
+  // since every register is written once, and allocated before the timed
+  // run, so taking one only copies the live counters.
+  struct OperationMemorySample
+  {
+    int64_t time = -1;
+    int thread;
+    long live_ctxts;
+  };
+  std::vector<OperationMemorySample> operation_memory_samples;
+  // One row of live_bytes_by_level per output register.
+  std::vector<long> operation_bytes_by_level;
+
+  // Each worker records into its own ring buffer, overwriting its oldest
+  // events once it is full. Times are nanoseconds since engine_start_time.
+  struct TraceEvent
+  {
+    int instruction;
+    int64_t wait_start;
+    int64_t start;
+    int64_t end;
+    size_t level;
+  };
+  struct TraceBuffer
+  {
+    std::vector<TraceEvent> events;
+    size_t num_recorded = 0;
+    // When the worker started waiting for the inputs of its next instruction.
+    int64_t wait_start = 0;
+  };
+  static constexpr size_t trace_buffer_capacity = 1 << 16;
+  std::vector<TraceBuffer> trace_buffers;
+  // When each instruction became ready, in DYNAMIC mode.
+  std::vector<int64_t> trace_ready_times;
+
+  // The operation types of the latency file, and their measured latencies in
+  // microseconds, indexed by the number of levels left.
+  const std::vector<std::string> latency_types = {"ADD", "SUB", "MUL", "BOOT"};
+  std::map<std::string, std::vector<double>> measured_latencies;
 
   double execution_time;
   int num_bootstraps;
@@ -81,26 +236,79 @@ Options:
   void generate_data_structures();
   void execute_in_plaintext();
   void setup_crypto_context();
+  std::string get_key_cache_entry(const std::string &) const;
+  bool load_crypto_context(const std::string &, const std::string &);
+  void store_crypto_context(const std::string &, const std::string &) const;
   void prepare_inputs();
   void execute_in_ciphertext();
   void verify_results();
   void write_execution_info_to_files();
 
   void parse_args(int, char **);
-  void update_dependence_info(const EngineOpInput &, const std::string &);
-  void handle_input_mutex(const std::string &);
+  void generate_registers();
+  Ctxt evaluate(const EngineInstruction &, std::atomic<int> &);
+  void evaluate_in_place(const EngineInstruction &, Ctxt &);
+  void release_inputs(const EngineInstruction &);
+  void account_ctxt(const Ctxt &, long);
+  void record_memory_sample(const std::string &, std::vector<MemorySample> &);
+  void record_operation_memory_sample(int);
+  void write_memory_profile() const;
+  void generate_trace_buffers();
+  int64_t get_trace_time() const;
+  void set_trace_wait_start(int64_t);
+  void record_trace_event(const EngineInstruction &, int64_t, size_t);
+  void write_trace() const;
+  void calibrate_latencies();
+  void measure_latencies();
+  Ctxt get_calibration_ctxt(int);
+  double time_operation(const std::function<void()> &) const;
+  void write_latency_file();
+
+  template <typename T>
+  T perform_phase(std::function<T()> func, const std::string &task_preamble, double *execution_time_ptr = nullptr)
+  {
+    if constexpr (std::is_void_v<T>)
+    {
+      utl::perform_func_and_print_execution_time(func, task_preamble, execution_time_ptr);
+      if (options.memory_profile)
+      {
+        record_memory_sample(task_preamble, memory_phase_samples);
+      }
+    }
+    else
+    {
+      auto result = utl::perform_func_and_print_execution_time(func, task_preamble, execution_time_ptr);
+      if (options.memory_profile)
+      {
+        record_memory_sample(task_preamble, memory_phase_samples);
+      }
+      return result;
+    }
+  }
+  void wait_until_ready(int);
+  void mark_ready(int);
+  void wait_for_inputs(const EngineInstruction &);
   int execute_schedule();
+  void execute_validation_instruction(const EngineInstruction &);
+  size_t get_num_workers() const;
+  void run_schedule_threads(const std::function<void(const EngineInstruction &)> &);
+  void run_coroutine_workers(const std::function<void(const EngineInstruction &)> &);
+  ScheduleThread run_schedule_thread(size_t, const std::function<void(const EngineInstruction &)> &, std::atomic<size_t> &);
+  void resume_waiters(int);
+  int execute_schedule_dynamically();
+  void execute_instruction(const EngineInstruction &, std::atomic<int> &);
+  void push_ready_instruction(int);
+  int pop_or_steal_instruction(int);
   void execute_validation_schedule();
   void generate_inputs();
   void generate_constant_inputs();
   void generate_random_inputs();
   void generate_inputs_from_file();
   void encrypt_inputs();
-  void generate_reg_locks();
-  void generate_dependence_locks();
-  void lock_all_mutexes();
+  void generate_ready_flags();
+  void generate_reg_waiters();
+  void generate_task_graph();
+  void reset_ready_flags();
   void bootstrap_initial_inputs();
-  Ctxt get_ctxt_input(const std::vector<EngineOpInput> &);
-  std::pair<Ctxt, Ctxt> get_ctxt_ctxt_inputs(const std::vector<EngineOpInput> &);
-  std::pair<Ctxt, Ptxt> get_ctxt_ptxt_inputs(const std::vector<EngineOpInput> &);
+  void print_instruction(const EngineInstruction &) const;
 };
\ No newline at end of file
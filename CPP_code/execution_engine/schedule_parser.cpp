@@ -13,6 +13,9 @@ ScheduleInfo ScheduleParser::parse(const CommandLineOptions &options)
   }
   sched_file.close();
 
+  flatten_instructions();
+  find_last_uses();
+
   if (options.mode == ExecMode::ALAP)
   {
     find_bootstrap_candidates();
@@ -38,8 +41,7 @@ void ScheduleParser::reset_parser(const CommandLineOptions &options)
 {
   this->options = options;
   sched_info = ScheduleInfo();
-  all_inputs.clear();
-  outputs.clear();
+  thread_instructions.clear();
 }
 
 void ScheduleParser::parse_line(const std::string &line_str)
@@ -66,35 +68,63 @@ void ScheduleParser::parse_line(const std::string &line_str)
     thread_idx = get_thread_idx(line[3]);
   }
 
-  EngineOperationPtr tmp = EngineOperationPtr(
-      new EngineOperation(op_type, output_key, input_key1, input_key2));
+  EngineOperation operation(op_type, output_key, input_key1, input_key2);
 
-  if ((long unsigned int) thread_idx >= sched_info.circuit.size())//Mihailo added casting to solve warnings treated as errors issue
+  if ((long unsigned int) thread_idx >= thread_instructions.size())//Mihailo added casting to solve warnings treated as errors issue
   {
-    sched_info.circuit.resize(thread_idx + 1);
+    thread_instructions.resize(thread_idx + 1);
   }
 
-  sched_info.circuit[thread_idx].push_back(tmp);
-
-  all_inputs.insert(tmp->get_inputs()[0]);
-  sched_info.dependent_outputs[input_key1].insert(output_key);
+  EngineInstruction instruction;
+  instruction.op_type = operation.get_op_type();
+  instruction.thread_idx = thread_idx;
+  instruction.input_regs = {-1, -1};
+  instruction.input_releases = {RegRelease::DECREMENT, RegRelease::DECREMENT};
+  instruction.in_place = false;
 
-  if (!input_key2.empty())
+  auto inputs = operation.get_inputs();
+  instruction.num_inputs = inputs.size();
+  for (size_t i = 0; i < inputs.size(); i++)
   {
-    all_inputs.insert(tmp->get_inputs()[1]);
-    sched_info.dependent_outputs[input_key2].insert(output_key);
+    auto reg = intern_key(inputs[i].key, inputs[i].is_ctxt);
+    instruction.input_regs[i] = reg;
+    sched_info.num_uses[reg]++;
   }
 
-  if (outputs.count(output_key))
+  instruction.output_reg = intern_key(output_key, true);
+  if (sched_info.reg_is_output[instruction.output_reg])
   {
     std::cout << "ERROR: Schedules must maintain SSA form." << std::endl;
     std::cout << "Ciphertext " << output_key << " is the output of multiple operations." << std::endl;
     exit(-1);
   }
-  else
+  sched_info.reg_is_output[instruction.output_reg] = true;
+
+  thread_instructions[thread_idx].push_back(instruction);
+}
+
+int ScheduleParser::intern_key(const std::string &key, bool is_ctxt)
+{
+  auto [it, inserted] = sched_info.reg_ids.emplace(key, sched_info.reg_keys.size());
+  if (inserted)
   {
-    outputs.insert(output_key);
+    sched_info.reg_keys.push_back(key);
+    sched_info.reg_is_ctxt.push_back(is_ctxt);
+    sched_info.reg_is_output.push_back(false);
+    sched_info.num_uses.push_back(0);
   }
+  return it->second;
+}
+
+void ScheduleParser::flatten_instructions()
+{
+  sched_info.thread_offsets.push_back(0);
+  for (const auto &instructions : thread_instructions)
+  {
+    sched_info.instructions.insert(sched_info.instructions.end(), instructions.begin(), instructions.end());
+    sched_info.thread_offsets.push_back(sched_info.instructions.size());
+  }
+  thread_instructions.clear();
 }
 
 int ScheduleParser::get_thread_idx(std::string thread_str) const
@@ -103,36 +133,94 @@ int ScheduleParser::get_thread_idx(std::string thread_str) const
   return std::stoi(thread_str) - 1;
 }
 
-void ScheduleParser::find_bootstrap_candidates()
+void ScheduleParser::find_last_uses()
 {
-  for (const auto &core_schedule : sched_info.circuit)
+  // A register whose uses are all on one thread dies at the last of them.
+  // DYNAMIC mode may reorder the instructions of a thread, so there the
+  // uses must all be in one instruction.
+  const auto num_regs = sched_info.get_num_regs();
+  std::vector<int> first_use(num_regs, -1);
+  std::vector<int> last_use(num_regs, -1);
+  std::vector<bool> single_thread(num_regs, true);
+  for (size_t i = 0; i < sched_info.instructions.size(); i++)
   {
-    for (const auto &op : core_schedule)
+    const auto &instruction = sched_info.instructions[i];
+    for (int j = 0; j < instruction.num_inputs; j++)
     {
-      auto inputs = op->get_inputs();
-      auto op_type = op->get_op_type();
-      if (op_type == CC_MUL)
+      auto reg = instruction.input_regs[j];
+      if (first_use[reg] < 0)
+      {
+        first_use[reg] = i;
+      }
+      else if (sched_info.instructions[first_use[reg]].thread_idx != instruction.thread_idx)
       {
-        sched_info.bootstrap_candidates.insert(inputs[0].key);
-        sched_info.bootstrap_candidates.insert(inputs[1].key);
+        single_thread[reg] = false;
       }
-      else if (op_type == CP_MUL)
+      last_use[reg] = i;
+    }
+  }
+
+  std::vector<bool> has_static_last_use(num_regs);
+  for (size_t reg = 0; reg < num_regs; reg++)
+  {
+    has_static_last_use[reg] = options.mode == ExecMode::DYNAMIC ? first_use[reg] == last_use[reg] : single_thread[reg];
+  }
+
+  for (size_t i = 0; i < sched_info.instructions.size(); i++)
+  {
+    auto &instruction = sched_info.instructions[i];
+    for (int j = 0; j < instruction.num_inputs; j++)
+    {
+      auto reg = instruction.input_regs[j];
+      if (has_static_last_use[reg])
       {
-        size_t i = inputs[0].is_ctxt ? 0 : 1;
-        sched_info.bootstrap_candidates.insert(inputs[i].key);
+        bool is_last = last_use[reg] == (int) i && (j == instruction.num_inputs - 1 || instruction.input_regs[j + 1] != reg);
+        instruction.input_releases[j] = is_last ? RegRelease::FREE : RegRelease::KEEP;
       }
     }
+    instruction.in_place = can_evaluate_in_place(instruction);
+  }
+}
+
+bool ScheduleParser::can_evaluate_in_place(const EngineInstruction &instruction) const
+{
+  // Multiplications and bootstraps always produce a new ciphertext.
+  if (instruction.op_type == CC_MUL || instruction.op_type == CP_MUL || instruction.op_type == BOOT)
+  {
+    return false;
+  }
+  const auto &inputs = instruction.input_regs;
+  return instruction.input_releases[0] == RegRelease::FREE &&
+         (instruction.num_inputs == 1 || inputs[1] != inputs[0]);
+}
+
+void ScheduleParser::find_bootstrap_candidates()
+{
+  sched_info.bootstrap_candidates.assign(sched_info.get_num_regs(), false);
+  for (const auto &instruction : sched_info.instructions)
+  {
+    const auto &inputs = instruction.input_regs;
+    if (instruction.op_type == CC_MUL)
+    {
+      sched_info.bootstrap_candidates[inputs[0]] = true;
+      sched_info.bootstrap_candidates[inputs[1]] = true;
+    }
+    else if (instruction.op_type == CP_MUL)
+    {
+      size_t i = sched_info.reg_is_ctxt[inputs[0]] ? 0 : 1;
+      sched_info.bootstrap_candidates[inputs[i]] = true;
+    }
   }
 }
 
-std::unordered_set<EngineOpInput, EngineOpInput::hash> ScheduleParser::get_initial_inputs() const
+std::vector<int> ScheduleParser::get_initial_inputs() const
 {
-  std::unordered_set<EngineOpInput, EngineOpInput::hash> initial_inputs;
-  for (const auto &input : all_inputs)
+  std::vector<int> initial_inputs;
+  for (size_t reg = 0; reg < sched_info.get_num_regs(); reg++)
   {
-    if (!outputs.count(input.key))
+    if (!sched_info.reg_is_output[reg])
     {
-      initial_inputs.insert(input);
+      initial_inputs.push_back(reg);
     }
   }
   return initial_inputs;
@@ -25,7 +25,9 @@ enum class ExecMode
 {
   BOOSTER,
   ALAP,
-  PLAINTEXT
+  PLAINTEXT,
+  DYNAMIC,
+  CALIBRATE
 };
 
 struct CommandLineOptions
@@ -38,19 +40,73 @@ struct CommandLineOptions
   std::string inputs_filename;
   ExecMode mode = ExecMode::BOOSTER;
   std::string mode_string = "BOOSTER";
+  int num_workers = 0;
   bool verify_results = false;
   bool bootstrap_inputs = false;
   std::string sched_filename;
   std::string eval_time_filename;
   std::string num_bootstraps_filename;
+  bool memory_profile = false;
+  std::string memory_profile_filename;
+  bool trace = false;
+  std::string trace_filename;
+  std::string latency_filename;
+  int calibration_repetitions = 10;
+  int calibration_warmups = 2;
+  double latency_unit = 0;
+  bool level_resolved_latencies = false;
+  std::string key_cache_dirname;
+};
+
+// What the engine does with an input register after an instruction reads it.
+enum class RegRelease : char
+{
+  // A later instruction of the same thread releases it.
+  KEEP,
+  // This instruction is known to be the last use.
+  FREE,
+  // The uses may run in any order, so the instruction that drops the
+  // register's use count to zero releases it.
+  DECREMENT
+};
+
+// An operation with its keys interned into register ids. Unused inputs are -1.
+struct EngineInstruction
+{
+  EngineOpType op_type;
+  int thread_idx;
+  int output_reg;
+  int num_inputs;
+  std::array<int, 2> input_regs;
+  std::array<RegRelease, 2> input_releases;
+  // The first input dies here, so its ciphertext is overwritten with the result.
+  bool in_place;
 };
 
 struct ScheduleInfo
 {
-  std::vector<std::vector<EngineOperationPtr>> circuit;
-  std::unordered_set<EngineOpInput, EngineOpInput::hash> initial_inputs;
-  std::unordered_set<std::string> bootstrap_candidates;
-  std::unordered_map<std::string, std::unordered_set<std::string>> dependent_outputs;
+  // The instructions of thread t are instructions[thread_offsets[t]] up to
+  // instructions[thread_offsets[t + 1]], in schedule order.
+  std::vector<EngineInstruction> instructions;
+  std::vector<size_t> thread_offsets;
+  // Indexed by register id.
+  std::vector<std::string> reg_keys;
+  std::vector<bool> reg_is_ctxt;
+  std::vector<bool> reg_is_output;
+  std::vector<bool> bootstrap_candidates;
+  std::vector<int> num_uses;
+  std::unordered_map<std::string, int> reg_ids;
+  std::vector<int> initial_inputs;
+
+  size_t get_num_threads() const
+  {
+    return thread_offsets.size() - 1;
+  }
+
+  size_t get_num_regs() const
+  {
+    return reg_keys.size();
+  }
 };
 
 class ScheduleParser
@@ -61,13 +117,16 @@ public:
 private:
   CommandLineOptions options;
   ScheduleInfo sched_info;
-  std::unordered_set<EngineOpInput, EngineOpInput::hash> all_inputs;
-  std::set<std::string> outputs;
+  std::vector<std::vector<EngineInstruction>> thread_instructions;
 
   void reset_parser(const CommandLineOptions &);
   std::ifstream open_sched_file();
   void parse_line(const std::string &);
+  int intern_key(const std::string &, bool);
+  void flatten_instructions();
+  void find_last_uses();
+  bool can_evaluate_in_place(const EngineInstruction &) const;
   void find_bootstrap_candidates();
   int get_thread_idx(std::string) const;
-  std::unordered_set<EngineOpInput, EngineOpInput::hash> get_initial_inputs() const;
+  std::vector<int> get_initial_inputs() const;
 };
\ No newline at end of file
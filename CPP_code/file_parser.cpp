@@ -15,7 +15,14 @@ void Program::FileParser::parse_latency_file(const std::string &latency_filename
     {
         auto line_as_list = utl::split_string_by_character(line, ',');
         auto type = OperationType(line_as_list[0]);
-        program.latencies[type] = std::stoi(line_as_list[1]);
+        if (line_as_list.size() == 3)
+        {
+            program.latencies.set_level_latency(type, std::stoi(line_as_list[1]), std::stoi(line_as_list[2]));
+        }
+        else
+        {
+            program.latencies.set_latency(type, std::stoi(line_as_list[1]));
+        }
         line = utl::get_trimmed_line_from_file(latency_file);
     }
 }
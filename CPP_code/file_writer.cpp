@@ -194,6 +194,14 @@ void FileWriter::write_lgr_info_to_file(std::ofstream &file, int total_latency)
         }
     }
 
+    for (const auto operation : program)
+    {
+        if (operation->is_bootstrapped() && operation->bootstrap_core_num > 0)
+        {
+            file << "B2C( OP" << operation->id << ", C" << operation->bootstrap_core_num << ") 1" << std::endl;
+        }
+    }
+
     for (const auto operation : program)
     {
         if (operation->bootstrap_start_time > 0)
@@ -258,49 +266,65 @@ void FileWriter::write_sched_file(std::ofstream &file) const
 {
     auto sched_data = get_sched_data_from_program();
 
-    for (const auto &[core_num, operations_on_core] : sched_data)
+    for (const auto &[core_num, tasks_on_core] : sched_data)
     {
-        for (const auto &operation : operations_on_core)
+        for (const auto &[start_time, is_bootstrap, operation] : tasks_on_core)
         {
-            std::string result_var = " c" + std::to_string(operation->id);
-
-            auto args = operation->sched_args;
-            for (const auto parent : operation->parent_ptrs)
+            if (is_bootstrap)
             {
-                if (operation->receives_bootstrapped_result_from(parent))
-                {
-
-                    std::string unbootstrapped = " c" + std::to_string(parent->id) + " ";
-                    std::string bootstrapped = " c0" + std::to_string(parent->id) + " ";
-                    while (args.find(unbootstrapped) != std::string::npos)
-                    {
-                        args = std::regex_replace(args, std::regex(unbootstrapped), bootstrapped);
-                    }
-                }
+                file << "BOOT c0" << operation->id << " c" << operation->id << " t" << core_num << std::endl;
+            }
+            else
+            {
+                write_sched_operation_line(file, operation, core_num);
             }
+        }
+    }
+}
 
-            std::string thread = "t" + std::to_string(core_num);
+void FileWriter::write_sched_operation_line(std::ofstream &file, const OperationPtr &operation, int core_num) const
+{
+    std::string result_var = " c" + std::to_string(operation->id);
+
+    auto args = operation->sched_args;
+    for (const auto parent : operation->parent_ptrs)
+    {
+        if (operation->receives_bootstrapped_result_from(parent))
+        {
 
-            file << operation->type.to_string() << result_var << args << thread << std::endl;
-            if (operation->is_bootstrapped())
+            std::string unbootstrapped = " c" + std::to_string(parent->id) + " ";
+            std::string bootstrapped = " c0" + std::to_string(parent->id) + " ";
+            while (args.find(unbootstrapped) != std::string::npos)
             {
-                file << "BOOT c0" << operation->id << " c" << operation->id << " t" << core_num << std::endl;
+                args = std::regex_replace(args, std::regex(unbootstrapped), bootstrapped);
             }
         }
     }
+
+    std::string thread = "t" + std::to_string(core_num);
+
+    file << operation->type.to_string() << result_var << args << thread << std::endl;
 }
 
+// Bootstraps without a recorded core or start time are placed right after
+// the operation that produces their input.
 FileWriter::SchedDataStructure FileWriter::get_sched_data_from_program() const
 {
     SchedDataStructure sched_data;
     for (const auto &operation : program_ref.get())
     {
-        auto core = operation->core_num;
-        // if (!sched_data.contains(core))
-        // {
-        //     sched_data.emplace(core);
-        // }
-        sched_data[core].insert(operation);
+        sched_data[operation->core_num].insert({operation->start_time, false, operation});
+
+        if (operation->is_bootstrapped())
+        {
+            auto bootstrap_core = operation->bootstrap_core_num > 0
+                                      ? operation->bootstrap_core_num
+                                      : operation->core_num;
+            auto bootstrap_start_time = operation->bootstrap_start_time > 0
+                                            ? operation->bootstrap_start_time
+                                            : operation->start_time;
+            sched_data[bootstrap_core].insert({bootstrap_start_time, true, operation});
+        }
     }
 
     return sched_data;
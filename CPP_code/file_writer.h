@@ -16,15 +16,28 @@ public:
     void write_sched_file(const std::string &) const;
 
 private:
-    struct StartTimeCmp
+    // An operation or the bootstrap of its result, as placed on a core.
+    struct ScheduledTask
     {
-        bool operator()(const OperationPtr &a, const OperationPtr &b) const
+        int start_time;
+        bool is_bootstrap;
+        OperationPtr operation;
+
+        bool operator<(const ScheduledTask &other) const
         {
-            return a->start_time < b->start_time;
+            if (start_time != other.start_time)
+            {
+                return start_time < other.start_time;
+            }
+            else if (is_bootstrap != other.is_bootstrap)
+            {
+                return is_bootstrap < other.is_bootstrap;
+            }
+            return operation->id < other.operation->id;
         }
     };
 
-    using SchedDataStructure = std::map<int, std::set<OperationPtr, StartTimeCmp>>;
+    using SchedDataStructure = std::map<int, std::set<ScheduledTask>>;
 
     std::reference_wrapper<const Program> program_ref;
 
@@ -45,5 +58,6 @@ private:
     void write_bootstrapping_set_to_file_selective_mode(std::ofstream &) const;
 
     void write_sched_file(std::ofstream &) const;
+    void write_sched_operation_line(std::ofstream &, const OperationPtr &, int) const;
     SchedDataStructure get_sched_data_from_program() const;
 };
\ No newline at end of file
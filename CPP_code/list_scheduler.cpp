@@ -12,14 +12,27 @@ ListScheduler::ListScheduler(int argc, char **argv)
 
     program = Program(in);
 
-    bootstrap_latency = program.get_latency_of(OperationType::BOOT);
+    initialize_cores();
+}
 
-    const auto num_threads = options.num_threads;
-    if (num_threads > 0)
+ListScheduler::ListScheduler(const Options &sweep_options, const Program &sweep_program)
+    : options(sweep_options), program(sweep_program)
+{
+    priority_policy = PriorityPolicy::create(options.priority_policy_string);
+    initialize_cores();
+}
+
+void ListScheduler::initialize_cores()
+{
+    if (!options.machine_filename.empty())
+    {
+        add_cores_from_machine_file();
+    }
+    else if (options.num_threads > 0)
     {
         for (int i = 1; i <= options.num_threads; i++)
         {
-            core_availability[i] = true;
+            add_core(i, program.get_latencies());
         }
     }
     else
@@ -28,6 +41,55 @@ ListScheduler::ListScheduler(int argc, char **argv)
         std::cout << "num_threads must be greater than 0.";
         exit(0);
     }
+
+    const auto num_threads = options.num_threads;
+    const auto num_bootstrap_cores = options.num_bootstrap_cores;
+    if (num_bootstrap_cores >= 0)
+    {
+        for (int i = 1; i <= num_bootstrap_cores; i++)
+        {
+            add_core(num_threads + i, program.get_latencies());
+        }
+    }
+    else
+    {
+        std::cout << help_info << std::endl;
+        std::cout << "num_bootstrap_cores must not be negative.";
+        exit(0);
+    }
+
+    if (!options.transfer_latency_filename.empty())
+    {
+        transfer_latencies = TransferLatencies(options.transfer_latency_filename, core_availability.size());
+    }
+
+    if (!options.contention_filename.empty())
+    {
+        contention_curve = ContentionCurve(options.contention_filename);
+    }
+}
+
+void ListScheduler::add_cores_from_machine_file()
+{
+    Machine machine(options.machine_filename, program.get_latencies());
+
+    int core_num = 1;
+    for (const auto &core_class : machine.get_core_classes())
+    {
+        for (int i = 0; i < core_class.num_cores; i++)
+        {
+            add_core(core_num, core_class.latencies);
+            core_num++;
+        }
+    }
+    options.num_threads = machine.get_num_cores();
+}
+
+void ListScheduler::add_core(int core_num, const LatencyMap &latencies)
+{
+    core_availability[core_num] = true;
+    core_latencies[core_num] = latencies;
+    core_finish_times[core_num] = 0;
 }
 
 void ListScheduler::run_simulation()
@@ -46,13 +108,51 @@ void ListScheduler::initialize_simulation_state()
     clock_cycle = 0;
     prioritized_unstarted_operations.clear();
     prioritized_unstarted_operations.insert(program.begin(), program.end());
+    ready_tasks.clear();
     running_operations.clear();
     bootstrapping_operations.clear();
+    finish_times.assign(program.size() + 1, 0);
+    bootstrap_finish_times.assign(program.size() + 1, 0);
+    if (options.num_levels > 0)
+    {
+        reset_bootstraps();
+    }
 
     initialize_pred_count();
+    initialize_ciphertext_uses();
     update_ready_operations();
 }
 
+// Every operation result c<id> stays live until its non-bootstrapped
+// consumers and its bootstrap have finished. The bootstrapped copy c0<id>
+// stays live until its consumers have finished. Values without consumers
+// are program outputs and stay live until the end.
+void ListScheduler::initialize_ciphertext_uses()
+{
+    remaining_uses.assign(program.size() + 1, 0);
+    remaining_bootstrapped_uses.assign(program.size() + 1, 0);
+    for (const auto &operation : program)
+    {
+        for (const auto &child : operation->child_ptrs)
+        {
+            if (child->receives_bootstrapped_result_from(operation))
+            {
+                remaining_bootstrapped_uses[operation->id]++;
+            }
+            else
+            {
+                remaining_uses[operation->id]++;
+            }
+        }
+        if (operation->is_bootstrapped())
+        {
+            remaining_uses[operation->id]++;
+        }
+    }
+    num_live_ciphertexts = 0;
+    peak_live_ciphertexts = 0;
+}
+
 void ListScheduler::initialize_pred_count()
 {
     for (const auto operation : program)
@@ -69,7 +169,7 @@ void ListScheduler::update_ready_operations()
         auto operation = *it;
         if (pred_count[operation] == 0)
         {
-            ready_operations.push_back(operation);
+            ready_tasks.insert({operation, false});
             it = prioritized_unstarted_operations.erase(it);
         }
         else
@@ -81,20 +181,27 @@ void ListScheduler::update_ready_operations()
 
 void ListScheduler::update_simulation_state()
 {
-    start_ready_operations();
+    start_ready_tasks();
 
     clock_cycle++;
 
-    finished_running_operations = handle_started_operations(running_operations);
-    finished_bootstrapping_operations = handle_started_operations(bootstrapping_operations);
+    auto num_contending_tasks = get_num_contending_tasks(true);
+    finished_running_operations = handle_started_operations(running_operations, finish_times, num_contending_tasks);
+    finished_bootstrapping_operations =
+        handle_started_operations(bootstrapping_operations, bootstrap_finish_times, num_contending_tasks);
+    if (options.num_levels > 0)
+    {
+        choose_bootstraps_of_finished_operations();
+    }
+    release_consumed_ciphertexts();
+    update_core_finish_time_estimates();
 
     update_pred_count();
     update_ready_operations();
+    queue_bootstraps_of_finished_operations();
 
-    mark_cores_available(finished_bootstrapping_operations);
+    mark_bootstrap_cores_available(finished_bootstrapping_operations);
     mark_cores_available(finished_running_operations);
-
-    start_bootstrapping_necessary_operations();
 }
 
 void ListScheduler::mark_cores_available(const OpSet &finished_operations)
@@ -105,69 +212,302 @@ void ListScheduler::mark_cores_available(const OpSet &finished_operations)
     }
 }
 
+void ListScheduler::mark_bootstrap_cores_available(const OpSet &finished_operations)
+{
+    for (const auto &op : finished_operations)
+    {
+        core_availability[op->bootstrap_core_num] = true;
+    }
+}
+
 bool ListScheduler::program_is_not_finished() const
 {
     return !prioritized_unstarted_operations.empty() ||
-           !ready_operations.empty() ||
+           !ready_tasks.empty() ||
            !running_operations.empty() ||
            !bootstrapping_operations.empty();
 }
 
-OpSet ListScheduler::handle_started_operations(std::map<OperationPtr, int> &started_operations)
+OpSet ListScheduler::handle_started_operations(std::map<OperationPtr, TaskProgress> &started_operations,
+                                               std::vector<int> &task_finish_times,
+                                               int num_contending_tasks)
 {
-    decrement_cycles_left(started_operations);
+    advance_started_operations(started_operations, num_contending_tasks);
     auto finished_operations = get_finished_operations(started_operations);
     utl::remove_key_subset_from_map(started_operations, finished_operations);
+    for (const auto &operation : finished_operations)
+    {
+        task_finish_times[operation->id] = clock_cycle;
+    }
     return finished_operations;
 }
 
-void ListScheduler::start_ready_operations()
+// The number of running BOOT and MUL tasks. Tasks still waiting for their
+// inputs only count if include_only_computing is false.
+int ListScheduler::get_num_contending_tasks(bool include_only_computing) const
 {
-    auto it = ready_operations.begin();
-    int available_core = get_available_core_num();
-    while (it != ready_operations.end() && (available_core != -1))
+    int num_contending_tasks = 0;
+    for (const auto *started_operations : {&running_operations, &bootstrapping_operations})
     {
-        auto operation = *it;
-        it = ready_operations.erase(it);
-        operation->start_time = clock_cycle;
-        running_operations[operation] = program.get_latency_of(operation->type);
+        for (const auto &[operation, progress] : *started_operations)
+        {
+            if (contention_curve.affects(progress.type) &&
+                (!include_only_computing || progress.start_time < clock_cycle))
+            {
+                num_contending_tasks++;
+            }
+        }
+    }
+    return num_contending_tasks;
+}
+
+// Starting another contending task is only worth it if it raises the
+// combined throughput of the contending tasks.
+bool ListScheduler::contention_allows(OperationType::Type type) const
+{
+    if (!contention_curve.affects(type))
+    {
+        return true;
+    }
+
+    double num_contending_tasks = get_num_contending_tasks(false);
+    auto current_throughput = num_contending_tasks / contention_curve.get_slowdown(type, num_contending_tasks);
+    auto new_throughput = (num_contending_tasks + 1) / contention_curve.get_slowdown(type, num_contending_tasks + 1);
+    return num_contending_tasks == 0 || new_throughput > current_throughput;
+}
 
-        int best_core = get_best_core_for_operation(operation, available_core);
-        operation->core_num = best_core;
-        core_availability[best_core] = false;
+// With a contention curve, the finish time of a running task changes
+// whenever the number of contending tasks does.
+void ListScheduler::update_core_finish_time_estimates()
+{
+    if (contention_curve.is_empty())
+    {
+        return;
+    }
 
-        available_core = get_available_core_num();
+    auto num_contending_tasks = get_num_contending_tasks(false);
+    for (const auto *started_operations : {&running_operations, &bootstrapping_operations})
+    {
+        for (const auto &[operation, progress] : *started_operations)
+        {
+            auto slowdown = contention_curve.get_slowdown(progress.type, num_contending_tasks);
+            core_finish_times[progress.core_num] =
+                std::max(progress.start_time, clock_cycle) + std::ceil(progress.work_left * slowdown);
+        }
     }
 }
 
+void ListScheduler::start_ready_tasks()
+{
+    auto core_ready_times = get_core_ready_times();
+
+    auto it = ready_tasks.begin();
+    while (it != ready_tasks.end() && any_core_is_available())
+    {
+        auto [operation, is_bootstrap] = *it;
+        if (!live_ciphertext_cap_allows(operation, is_bootstrap) ||
+            !contention_allows(get_task_type(operation, is_bootstrap)))
+        {
+            it++;
+            continue;
+        }
+
+        auto [best_core, finish_time] = get_earliest_finish_core(operation, is_bootstrap, core_ready_times);
+        if (best_core == -1 || !core_is_available(best_core))
+        {
+            if (best_core != -1)
+            {
+                core_ready_times[best_core] = finish_time;
+            }
+            it++;
+            continue;
+        }
+        it = ready_tasks.erase(it);
+
+        if (is_bootstrap)
+        {
+            start_bootstrap(operation, best_core);
+        }
+        else
+        {
+            start_operation(operation, best_core);
+        }
+        core_ready_times[operation_core(operation, is_bootstrap)] = finish_time;
+        add_live_ciphertext();
+    }
+}
+
+// A task starts once its inputs have been moved to the chosen core. The
+// core is held while the inputs are in flight.
+void ListScheduler::start_operation(const OperationPtr &operation, int available_core)
+{
+    if (options.num_levels > 0)
+    {
+        operation->level = get_input_levels(operation);
+    }
+    int best_core = get_best_core_for_operation(operation, available_core);
+    int start_time = std::max(clock_cycle, get_input_ready_time(operation, false, best_core));
+    int latency = get_latency_on_core(operation, false, best_core);
+    int finish_time = get_finish_time_on_core(operation, false, best_core, clock_cycle);
+
+    operation->start_time = start_time;
+    running_operations[operation] = {start_time, double(latency), operation->type, best_core};
+
+    operation->core_num = best_core;
+    occupy_core(best_core, finish_time);
+}
+
+void ListScheduler::start_bootstrap(const OperationPtr &operation, int available_core)
+{
+    int best_core = get_best_core_for_bootstrap(operation, available_core);
+    int start_time = std::max(clock_cycle, get_input_ready_time(operation, true, best_core));
+    int latency = get_latency_on_core(operation, true, best_core);
+    int finish_time = get_finish_time_on_core(operation, true, best_core, clock_cycle);
+
+    operation->bootstrap_start_time = start_time;
+    bootstrapping_operations[operation] = {start_time, double(latency), OperationType::BOOT, best_core};
+
+    operation->bootstrap_core_num = best_core;
+    occupy_core(best_core, finish_time);
+}
+
+void ListScheduler::occupy_core(int core_num, int finish_time)
+{
+    core_availability[core_num] = false;
+    core_finish_times[core_num] = finish_time;
+}
+
+// A core picked during refinement comes first. Otherwise prefers a core
+// that already holds one of the operation's inputs, as long as it is no
+// slower than the fallback core.
 int ListScheduler::get_best_core_for_operation(const OperationPtr &operation, int fallback_core) const
 {
+    if (preferred_core_is_usable(preferred_cores[operation->id], false))
+    {
+        return preferred_cores[operation->id];
+    }
+
     int best_core = fallback_core;
     for (const auto &parent : operation->parent_ptrs)
     {
-        if (core_is_available(parent->core_num))
+        auto input_core = operation->receives_bootstrapped_result_from(parent)
+                              ? parent->bootstrap_core_num
+                              : parent->core_num;
+        if (core_can_run(input_core, false) &&
+            core_is_available(input_core) &&
+            finishes_no_later_on(operation, false, input_core, fallback_core))
         {
-            best_core = parent->core_num;
+            best_core = input_core;
         }
     }
     return best_core;
 }
 
-void ListScheduler::decrement_cycles_left(std::map<OperationPtr, int> &started_operations)
+int ListScheduler::get_best_core_for_bootstrap(const OperationPtr &operation, int fallback_core) const
+{
+    if (preferred_core_is_usable(preferred_bootstrap_cores[operation->id], true))
+    {
+        return preferred_bootstrap_cores[operation->id];
+    }
+
+    auto producer_core = operation->core_num;
+    if (core_can_run(producer_core, true) &&
+        core_is_available(producer_core) &&
+        finishes_no_later_on(operation, true, producer_core, fallback_core))
+    {
+        return producer_core;
+    }
+    return fallback_core;
+}
+
+bool ListScheduler::preferred_core_is_usable(int core_num, bool is_bootstrap) const
+{
+    return core_num > 0 && core_can_run(core_num, is_bootstrap) && core_is_available(core_num);
+}
+
+bool ListScheduler::finishes_no_later_on(const OperationPtr &operation,
+                                         bool is_bootstrap,
+                                         int core_num,
+                                         int other_core_num) const
+{
+    return get_finish_time_on_core(operation, is_bootstrap, core_num, clock_cycle) <=
+           get_finish_time_on_core(operation, is_bootstrap, other_core_num, clock_cycle);
+}
+
+int ListScheduler::get_finish_time_on_core(const OperationPtr &operation,
+                                           bool is_bootstrap,
+                                           int core_num,
+                                           int core_ready_time) const
+{
+    auto type = get_task_type(operation, is_bootstrap);
+    auto start_time = std::max(core_ready_time, get_input_ready_time(operation, is_bootstrap, core_num));
+    auto latency = get_latency_on_core(operation, is_bootstrap, core_num);
+    if (contention_curve.affects(type))
+    {
+        auto slowdown = contention_curve.get_slowdown(type, get_num_contending_tasks(false) + 1);
+        return start_time + std::ceil(latency * slowdown);
+    }
+    return start_time + latency;
+}
+
+OperationType::Type ListScheduler::get_task_type(const OperationPtr &operation, bool is_bootstrap) const
+{
+    return is_bootstrap ? OperationType::BOOT : OperationType::Type(operation->type);
+}
+
+// The cycle at which every input of the task can be on the given core.
+// A bootstrap's only input is the result of its own operation.
+int ListScheduler::get_input_ready_time(const OperationPtr &operation, bool is_bootstrap, int core_num) const
+{
+    if (is_bootstrap)
+    {
+        return get_result_ready_time(operation, false) +
+               transfer_latencies.get_latency(operation->core_num, core_num);
+    }
+
+    int input_ready_time = 0;
+    for (const auto &parent : operation->parent_ptrs)
+    {
+        auto bootstrapped = operation->receives_bootstrapped_result_from(parent);
+        auto arrival_time = get_result_ready_time(parent, bootstrapped) +
+                            transfer_latencies.get_latency(operation_core(parent, bootstrapped), core_num);
+        input_ready_time = std::max(input_ready_time, arrival_time);
+    }
+    return input_ready_time;
+}
+
+int ListScheduler::get_result_ready_time(const OperationPtr &operation, bool bootstrapped) const
+{
+    return bootstrapped ? bootstrap_finish_times[operation->id] : finish_times[operation->id];
+}
+
+int ListScheduler::get_latency_on_core(const OperationPtr &operation, bool is_bootstrap, int core_num) const
 {
-    for (auto &[operation, time_left] : started_operations)
+    const auto &latencies = core_latencies.at(core_num);
+    return is_bootstrap ? operation->get_bootstrap_latency(latencies) : operation->get_latency(latencies);
+}
+
+// Advances every task that computed during the last cycle by one cycle
+// of uncontended work, or less if it was slowed down by contention.
+void ListScheduler::advance_started_operations(std::map<OperationPtr, TaskProgress> &started_operations,
+                                               int num_contending_tasks)
+{
+    for (auto &[operation, progress] : started_operations)
     {
-        time_left--;
+        if (progress.start_time < clock_cycle)
+        {
+            progress.work_left -= 1 / contention_curve.get_slowdown(progress.type, num_contending_tasks);
+        }
     }
 }
 
-OpSet ListScheduler::get_finished_operations(std::map<OperationPtr, int> &started_operations)
+OpSet ListScheduler::get_finished_operations(std::map<OperationPtr, TaskProgress> &started_operations)
 {
     OpSet finished_operations;
 
-    for (auto &[operation, time_left] : started_operations)
+    for (auto &[operation, progress] : started_operations)
     {
-        if (time_left == 0)
+        if (progress.work_left < 1e-9)
         {
             finished_operations.insert(operation);
         }
@@ -176,28 +516,216 @@ OpSet ListScheduler::get_finished_operations(std::map<OperationPtr, int> &starte
     return finished_operations;
 }
 
-void ListScheduler::start_bootstrapping_necessary_operations()
+void ListScheduler::reset_bootstraps()
+{
+    program.reset_bootstrap_set();
+    for (const auto &operation : program)
+    {
+        operation->bootstrap_start_time = 0;
+        operation->bootstrap_core_num = 0;
+    }
+    remaining_levels.assign(program.size() + 1, options.num_levels);
+}
+
+// The largest number of multiplications on a path that starts with the
+// operation.
+void ListScheduler::initialize_levels_needed()
+{
+    levels_needed.assign(program.size() + 1, 0);
+    for (const auto &operation : program | std::views::reverse)
+    {
+        int max_child_levels = 0;
+        for (const auto &child : operation->child_ptrs)
+        {
+            max_child_levels = std::max(max_child_levels, levels_needed[child->id]);
+        }
+        levels_needed[operation->id] = max_child_levels + (operation->type == OperationType::MUL ? 1 : 0);
+    }
+}
+
+// Decides whether to bootstrap the results of the operations that just
+// finished, before any of their children can start. A result is
+// bootstrapped for the children that need more levels than it has left.
+// This is forced once a multiplication child would run out of levels, and
+// done a level early when one bootstrap can serve several children, since
+// each of them would otherwise need its own bootstrap later on.
+void ListScheduler::choose_bootstraps_of_finished_operations()
+{
+    for (const auto &operation : finished_running_operations)
+    {
+        auto levels = get_remaining_levels(operation);
+        remaining_levels[operation->id] = levels;
+
+        std::vector<OperationPtr> children_to_refresh;
+        bool is_forced = false;
+        for (const auto &child : operation->child_ptrs)
+        {
+            if (levels_needed[child->id] > levels)
+            {
+                children_to_refresh.push_back(child);
+                is_forced = is_forced || (child->type == OperationType::MUL && levels == 0);
+            }
+        }
+
+        bool is_shared = children_to_refresh.size() > 1 && levels <= 1;
+        if (children_to_refresh.empty() || !(is_forced || is_shared))
+        {
+            continue;
+        }
+
+        for (const auto &child : children_to_refresh)
+        {
+            operation->bootstrap_children.insert(child);
+            remaining_uses[operation->id]--;
+            remaining_bootstrapped_uses[operation->id]++;
+        }
+        remaining_uses[operation->id]++;
+    }
+}
+
+// Fresh inputs and bootstrapped results have every level left.
+int ListScheduler::get_input_levels(const OperationPtr &operation) const
+{
+    int levels = options.num_levels;
+    for (const auto &parent : operation->parent_ptrs)
+    {
+        if (!operation->receives_bootstrapped_result_from(parent))
+        {
+            levels = std::min(levels, remaining_levels[parent->id]);
+        }
+    }
+    return levels;
+}
+
+// Each multiplication uses one level.
+int ListScheduler::get_remaining_levels(const OperationPtr &operation) const
+{
+    return get_input_levels(operation) - (operation->type == OperationType::MUL ? 1 : 0);
+}
+
+void ListScheduler::queue_bootstraps_of_finished_operations()
 {
     for (auto operation : finished_running_operations)
     {
         if (operation->is_bootstrapped())
         {
-            bootstrapping_operations[operation] = bootstrap_latency;
-            core_availability[operation->core_num] = false;
+            ready_tasks.insert({operation, true});
         }
     }
 }
 
-int ListScheduler::get_available_core_num() const
+// Every task creates one ciphertext. At the cap, only tasks that are the
+// last reader of one of their inputs may start, since they release at
+// least as many values as they create. If nothing is running, any task is
+// let through so the schedule cannot deadlock.
+bool ListScheduler::live_ciphertext_cap_allows(const OperationPtr &operation, bool is_bootstrap) const
 {
+    if (options.max_live_ciphertexts == 0 || num_live_ciphertexts < options.max_live_ciphertexts)
+    {
+        return true;
+    }
+    if (running_operations.empty() && bootstrapping_operations.empty())
+    {
+        return true;
+    }
+    return releases_an_input(operation, is_bootstrap);
+}
+
+bool ListScheduler::releases_an_input(const OperationPtr &operation, bool is_bootstrap) const
+{
+    if (is_bootstrap)
+    {
+        return remaining_uses[operation->id] == 1;
+    }
+    return std::ranges::any_of(operation->parent_ptrs, [&](const auto &parent)
+                               {
+                                   const auto &uses = operation->receives_bootstrapped_result_from(parent)
+                                                          ? remaining_bootstrapped_uses
+                                                          : remaining_uses;
+                                   return uses[parent->id] == 1; });
+}
+
+void ListScheduler::add_live_ciphertext()
+{
+    num_live_ciphertexts++;
+    peak_live_ciphertexts = std::max(peak_live_ciphertexts, num_live_ciphertexts);
+}
+
+void ListScheduler::release_consumed_ciphertexts()
+{
+    for (const auto &operation : finished_running_operations)
+    {
+        for (const auto &parent : operation->parent_ptrs)
+        {
+            release_ciphertext_use(parent, operation->receives_bootstrapped_result_from(parent));
+        }
+    }
+    for (const auto &operation : finished_bootstrapping_operations)
+    {
+        release_ciphertext_use(operation, false);
+    }
+}
+
+void ListScheduler::release_ciphertext_use(const OperationPtr &producer, bool bootstrapped)
+{
+    auto &uses = bootstrapped ? remaining_bootstrapped_uses : remaining_uses;
+    uses[producer->id]--;
+    if (uses[producer->id] == 0)
+    {
+        num_live_ciphertexts--;
+    }
+}
+
+int ListScheduler::get_peak_live_ciphertexts() const
+{
+    return peak_live_ciphertexts;
+}
+
+std::unordered_map<int, int> ListScheduler::get_core_ready_times() const
+{
+    std::unordered_map<int, int> core_ready_times;
     for (const auto &[core_num, available] : core_availability)
     {
-        if (available)
+        core_ready_times[core_num] = available ? clock_cycle : core_finish_times.at(core_num);
+    }
+    return core_ready_times;
+}
+
+// Returns the core on which the task would finish first, and when,
+// counting the wait for busy cores. A task whose best core is still busy
+// waits for it instead of taking a slower idle core, and reserves it so
+// the lower priority tasks behind it look elsewhere.
+std::pair<int, int> ListScheduler::get_earliest_finish_core(const OperationPtr &operation,
+                                                            bool is_bootstrap,
+                                                            const std::unordered_map<int, int> &core_ready_times) const
+{
+    int best_core = -1;
+    int best_finish_time = std::numeric_limits<int>::max();
+    for (const auto &[core_num, available] : core_availability)
+    {
+        if (!core_can_run(core_num, is_bootstrap))
         {
-            return core_num;
+            continue;
+        }
+
+        auto finish_time = get_finish_time_on_core(operation, is_bootstrap, core_num, core_ready_times.at(core_num));
+        if (finish_time < best_finish_time)
+        {
+            best_core = core_num;
+            best_finish_time = finish_time;
         }
     }
-    return -1;
+    return {best_core, best_finish_time};
+}
+
+int ListScheduler::operation_core(const OperationPtr &operation, bool is_bootstrap) const
+{
+    return is_bootstrap ? operation->bootstrap_core_num : operation->core_num;
+}
+
+bool ListScheduler::any_core_is_available() const
+{
+    return std::ranges::any_of(core_availability, [](const auto &core) { return core.second; });
 }
 
 bool ListScheduler::core_is_available(int core_num) const
@@ -205,14 +733,213 @@ bool ListScheduler::core_is_available(int core_num) const
     return core_availability.at(core_num);
 }
 
+// Without dedicated bootstrap cores, every core runs every task.
+// Otherwise cores past num_threads only run bootstraps.
+bool ListScheduler::core_can_run(int core_num, bool is_bootstrap) const
+{
+    if (options.num_bootstrap_cores == 0)
+    {
+        return true;
+    }
+    bool is_bootstrap_core = core_num > options.num_threads;
+    return is_bootstrap == is_bootstrap_core;
+}
+
 void ListScheduler::perform_list_scheduling()
 {
     std::cout << "Generating schedule..." << std::endl;
     program.update_slack_for_every_operation();
+    initialize_priorities();
+    if (options.num_levels > 0)
+    {
+        program.set_boot_mode(BootstrapMode::SELECTIVE);
+        initialize_levels_needed();
+        // The policy cannot rank bootstraps that are only placed during the
+        // simulation, so they start out with the priority of their
+        // operation. Refinement may change them from there.
+        bootstrap_priorities = priorities;
+    }
     run_simulation();
+    if (options.time_budget.is_limited() || options.max_iterations > 0)
+    {
+        refine_schedule();
+    }
     std::cout << "Done." << std::endl;
 }
 
+void ListScheduler::initialize_priorities()
+{
+    priorities = priority_policy->get_priorities(program);
+    bootstrap_priorities = priority_policy->get_bootstrap_priorities(program);
+    preferred_cores.assign(program.size() + 1, 0);
+    preferred_bootstrap_cores.assign(program.size() + 1, 0);
+}
+
+// Simulated annealing over the priorities and the preferred cores of the
+// tasks. Every candidate is a few random moves away from the current state
+// and is evaluated by a full simulation. Worse candidates are accepted with
+// a probability that shrinks as the budget runs out.
+void ListScheduler::refine_schedule()
+{
+    auto quality_log = utl::QualityLog(options.time_budget);
+    std::minstd_rand rand_gen(options.seed);
+    std::uniform_real_distribution<double> unit(0, 1);
+
+    SearchState current{priorities, bootstrap_priorities, preferred_cores, preferred_bootstrap_cores, get_placements()};
+    auto current_latency = solver_latency;
+    auto best_latency = solver_latency;
+    auto best_placements = get_placements();
+    auto best_peak_live_ciphertexts = peak_live_ciphertexts;
+    quality_log.record(best_latency);
+
+    const double initial_temperature = std::max(1.0, solver_latency * 0.01);
+    for (int iteration = 0; !refinement_budget_expired(iteration); iteration++)
+    {
+        SearchState candidate{current.priorities,
+                              current.bootstrap_priorities,
+                              current.preferred_cores,
+                              current.preferred_bootstrap_cores,
+                              {}};
+        perturb_search_state(candidate, current.placements, rand_gen);
+        apply_search_state(candidate);
+        run_simulation();
+
+        auto temperature = initial_temperature * (1 - get_refinement_progress(iteration));
+        auto delta = solver_latency - current_latency;
+        if (delta <= 0 || (temperature > 0 && unit(rand_gen) < std::exp(-delta / temperature)))
+        {
+            current = std::move(candidate);
+            current.placements = get_placements();
+            current_latency = solver_latency;
+        }
+
+        if (solver_latency < best_latency)
+        {
+            best_latency = solver_latency;
+            best_placements = get_placements();
+            best_peak_live_ciphertexts = peak_live_ciphertexts;
+            quality_log.record(best_latency);
+        }
+    }
+
+    apply_placements(best_placements);
+    solver_latency = best_latency;
+    peak_live_ciphertexts = best_peak_live_ciphertexts;
+
+    quality_log.write_to_file(options.output_filename + "_quality.csv");
+}
+
+bool ListScheduler::refinement_budget_expired(int iteration) const
+{
+    if (options.max_iterations > 0 && iteration >= options.max_iterations)
+    {
+        return true;
+    }
+    return options.time_budget.expired();
+}
+
+// The larger of the used fractions of the iteration and time budgets.
+double ListScheduler::get_refinement_progress(int iteration) const
+{
+    double progress = 0;
+    if (options.max_iterations > 0)
+    {
+        progress = double(iteration) / options.max_iterations;
+    }
+    if (options.time_budget.is_limited())
+    {
+        auto total_seconds = options.time_budget.elapsed_seconds() + options.time_budget.remaining_seconds();
+        progress = std::max(progress, options.time_budget.elapsed_seconds() / total_seconds);
+    }
+    return std::min(progress, 1.0);
+}
+
+// Each move either redraws one task's priority, swaps the priorities of
+// two tasks, or swaps the cores of two tasks in the schedule of the
+// accepted state.
+void ListScheduler::perturb_search_state(SearchState &state,
+                                         const std::vector<OperationPlacement> &placements,
+                                         std::minstd_rand &rand_gen) const
+{
+    auto is_bootstrapped = [&placements](const OperationPtr &operation)
+    { return !placements[operation->id - 1].bootstrap_children.empty(); };
+    auto placed_core = [&placements](const OperationPtr &operation, bool is_bootstrap)
+    {
+        const auto &placement = placements[operation->id - 1];
+        return is_bootstrap ? placement.bootstrap_core_num : placement.core_num;
+    };
+
+    const int num_operations = program.size();
+    const auto [min_priority, max_priority] = std::ranges::minmax(state.priorities | std::views::drop(1));
+    std::uniform_real_distribution<double> new_priority(min_priority, max_priority);
+    std::uniform_int_distribution<int> random_id(1, num_operations);
+    std::uniform_int_distribution<int> random_move(0, 2);
+    std::bernoulli_distribution pick_bootstrap(0.5);
+
+    const int num_moves = 1 + num_operations / 100;
+    for (int move = 0; move < num_moves; move++)
+    {
+        auto a = program.get_operation_ptr_from_id(random_id(rand_gen));
+        auto b = program.get_operation_ptr_from_id(random_id(rand_gen));
+        bool use_bootstrap_tasks = pick_bootstrap(rand_gen) && is_bootstrapped(a) && is_bootstrapped(b);
+        auto &task_priorities = use_bootstrap_tasks ? state.bootstrap_priorities : state.priorities;
+        auto &task_cores = use_bootstrap_tasks ? state.preferred_bootstrap_cores : state.preferred_cores;
+
+        switch (random_move(rand_gen))
+        {
+        case 0:
+            task_priorities[a->id] = new_priority(rand_gen);
+            break;
+        case 1:
+            std::swap(task_priorities[a->id], task_priorities[b->id]);
+            break;
+        default:
+            task_cores[a->id] = placed_core(b, use_bootstrap_tasks);
+            task_cores[b->id] = placed_core(a, use_bootstrap_tasks);
+            break;
+        }
+    }
+}
+
+void ListScheduler::apply_search_state(const SearchState &state)
+{
+    priorities = state.priorities;
+    bootstrap_priorities = state.bootstrap_priorities;
+    preferred_cores = state.preferred_cores;
+    preferred_bootstrap_cores = state.preferred_bootstrap_cores;
+}
+
+std::vector<ListScheduler::OperationPlacement> ListScheduler::get_placements() const
+{
+    std::vector<OperationPlacement> placements;
+    for (const auto operation : program)
+    {
+        placements.push_back({operation->start_time,
+                              operation->core_num,
+                              operation->bootstrap_start_time,
+                              operation->bootstrap_core_num,
+                              finish_times[operation->id],
+                              bootstrap_finish_times[operation->id],
+                              operation->bootstrap_children});
+    }
+    return placements;
+}
+
+void ListScheduler::apply_placements(const std::vector<OperationPlacement> &placements)
+{
+    for (const auto operation : program)
+    {
+        const auto &placement = placements[operation->id - 1];
+        operation->start_time = placement.start_time;
+        operation->core_num = placement.core_num;
+        operation->bootstrap_start_time = placement.bootstrap_start_time;
+        operation->bootstrap_core_num = placement.bootstrap_core_num;
+        finish_times[operation->id] = placement.finish_time;
+        bootstrap_finish_times[operation->id] = placement.bootstrap_finish_time;
+        operation->bootstrap_children = placement.bootstrap_children;
+    }
+}
+
 void ListScheduler::update_pred_count()
 {
     for (auto &op : finished_running_operations)
@@ -256,7 +983,44 @@ void ListScheduler::parse_args(int argc, char **argv)
     auto num_threads_string = utl::get_arg(options_string, "-t", "--num-threads", help_info);
     if (!num_threads_string.empty())
     {
-        options.num_threads = std::stoi(num_threads_string);
+        options.thread_counts = parse_thread_counts(num_threads_string);
+        if (options.thread_counts.empty())
+        {
+            std::cout << help_info << std::endl;
+            std::cout << "No thread counts in " << num_threads_string << std::endl;
+            exit(1);
+        }
+        options.num_threads = options.thread_counts.front();
+    }
+
+    auto machine_arg = utl::get_arg(options_string, "-M", "--machine-file", help_info);
+    if (!machine_arg.empty())
+    {
+        options.machine_filename = machine_arg;
+    }
+
+    auto transfer_arg = utl::get_arg(options_string, "-x", "--transfer-latency-file", help_info);
+    if (!transfer_arg.empty())
+    {
+        options.transfer_latency_filename = transfer_arg;
+    }
+
+    auto contention_arg = utl::get_arg(options_string, "-C", "--contention-file", help_info);
+    if (!contention_arg.empty())
+    {
+        options.contention_filename = contention_arg;
+    }
+
+    auto max_live_string = utl::get_arg(options_string, "-c", "--max-live-ciphertexts", help_info);
+    if (!max_live_string.empty())
+    {
+        options.max_live_ciphertexts = std::stoi(max_live_string);
+    }
+
+    auto num_bootstrap_cores_string = utl::get_arg(options_string, "-b", "--bootstrap-cores", help_info);
+    if (!num_bootstrap_cores_string.empty())
+    {
+        options.num_bootstrap_cores = std::stoi(num_bootstrap_cores_string);
     }
 
     auto bootstrap_arg = utl::get_arg(options_string, "-i", "--input-lgr", help_info);
@@ -270,6 +1034,57 @@ void ListScheduler::parse_args(int argc, char **argv)
     {
         options.latency_filename = latency_arg;
     }
+
+    auto priority_arg = utl::get_arg(options_string, "-p", "--priority", help_info);
+    if (!priority_arg.empty())
+    {
+        options.priority_policy_string = priority_arg;
+    }
+
+    try
+    {
+        priority_policy = PriorityPolicy::create(options.priority_policy_string);
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << help_info << std::endl;
+        std::cout << e.what() << std::endl;
+        exit(1);
+    }
+
+    options.time_budget = utl::get_time_budget_arg(options_string, help_info);
+
+    auto iterations_string = utl::get_arg(options_string, "-n", "--iterations", help_info);
+    if (!iterations_string.empty())
+    {
+        options.max_iterations = std::stoi(iterations_string);
+    }
+
+    auto num_levels_string = utl::get_arg(options_string, "-L", "--num-levels", help_info);
+    if (!num_levels_string.empty())
+    {
+        options.num_levels = std::stoi(num_levels_string);
+    }
+
+    auto seed_string = utl::get_arg(options_string, "-s", "--seed", help_info);
+    if (!seed_string.empty())
+    {
+        options.seed = std::stoul(seed_string);
+    }
+
+    if (options.num_levels > 0 && options.bootstrap_filename != "NULL")
+    {
+        std::cout << help_info << std::endl;
+        std::cout << "A number of levels cannot be combined with an input .lgr file." << std::endl;
+        exit(1);
+    }
+
+    if (is_thread_count_sweep() && !options.machine_filename.empty())
+    {
+        std::cout << help_info << std::endl;
+        std::cout << "A list of thread counts cannot be combined with a machine file." << std::endl;
+        exit(1);
+    }
 }
 
 void ListScheduler::print_options() const
@@ -278,7 +1093,21 @@ void ListScheduler::print_options() const
     std::cout << "latency_filename: " << options.latency_filename << std::endl;
     std::cout << "output_filename: " << options.output_filename << std::endl;
     std::cout << "bootstrap_filename: " << options.bootstrap_filename << std::endl;
-    std::cout << "num_threads: " << options.num_threads << std::endl;
+    std::cout << "num_threads:";
+    for (auto num_threads : options.thread_counts)
+    {
+        std::cout << " " << num_threads;
+    }
+    std::cout << std::endl;
+    std::cout << "num_bootstrap_cores: " << options.num_bootstrap_cores << std::endl;
+    std::cout << "machine_filename: " << options.machine_filename << std::endl;
+    std::cout << "transfer_latency_filename: " << options.transfer_latency_filename << std::endl;
+    std::cout << "max_live_ciphertexts: " << options.max_live_ciphertexts << std::endl;
+    std::cout << "contention_filename: " << options.contention_filename << std::endl;
+    std::cout << "priority_policy: " << priority_policy->to_string() << std::endl;
+    std::cout << "num_levels: " << options.num_levels << std::endl;
+    std::cout << "max_iterations: " << options.max_iterations << std::endl;
+    std::cout << "seed: " << options.seed << std::endl;
 }
 
 void ListScheduler::write_to_output_files() const
@@ -286,6 +1115,219 @@ void ListScheduler::write_to_output_files() const
     auto file_writer = FileWriter(std::ref(program));
     file_writer.write_lgr_info_to_file(options.output_filename + ".lgr", solver_latency);
     file_writer.write_sched_file(options.output_filename + ".sched");
+    write_report_file(options.output_filename + "_report.txt");
+}
+
+// Lower bounds on the makespan of any schedule of the chosen bootstrap set
+// on these cores. Transfers and contention are ignored, and every task is
+// assumed to run on the fastest core that may run it.
+ListScheduler::LowerBounds ListScheduler::get_lower_bounds() const
+{
+    LowerBounds bounds;
+
+    auto ready_times = std::vector<int>(program.size() + 1);
+    auto operation_finish_times = std::vector<int>(program.size() + 1);
+    auto bootstrapped_finish_times = std::vector<int>(program.size() + 1);
+    double operation_work = 0;
+    double bootstrap_work = 0;
+    for (const auto operation : program)
+    {
+        int ready_time = 0;
+        for (const auto &parent : operation->parent_ptrs)
+        {
+            ready_time = std::max(ready_time,
+                                  operation->receives_bootstrapped_result_from(parent)
+                                      ? bootstrapped_finish_times[parent->id]
+                                      : operation_finish_times[parent->id]);
+        }
+        ready_times[operation->id] = ready_time;
+        operation_finish_times[operation->id] = ready_time + get_fastest_latency(operation, false);
+        operation_work += get_fastest_latency(operation, false);
+
+        if (operation->is_bootstrapped())
+        {
+            bootstrapped_finish_times[operation->id] =
+                operation_finish_times[operation->id] + get_fastest_latency(operation, true);
+            bootstrap_work += get_fastest_latency(operation, true);
+        }
+        bounds.critical_path = std::max({bounds.critical_path,
+                                         operation_finish_times[operation->id],
+                                         bootstrapped_finish_times[operation->id]});
+    }
+
+    int num_cores = core_availability.size();
+    if (options.num_bootstrap_cores == 0)
+    {
+        bounds.total_work = std::ceil((operation_work + bootstrap_work) / num_cores);
+    }
+    else
+    {
+        bounds.total_work = std::ceil(std::max(operation_work / options.num_threads,
+                                               bootstrap_work / options.num_bootstrap_cores));
+    }
+
+    bounds.bootstrap_resource = get_bootstrap_resource_bound(operation_finish_times, bootstrap_work);
+
+    return bounds;
+}
+
+// No bootstrap starts before the earliest one can, the bootstrap cores
+// must process all bootstrap work, and the last bootstrap is followed by
+// at least the shortest remaining path of any bootstrap.
+int ListScheduler::get_bootstrap_resource_bound(const std::vector<int> &operation_finish_times,
+                                                double bootstrap_work) const
+{
+    auto bottom_levels = std::vector<int>(program.size() + 1);
+    std::ranges::reverse_view reverse_program{program};
+    for (const auto operation : reverse_program)
+    {
+        int max_child_level = 0;
+        for (const auto &child : operation->child_ptrs)
+        {
+            auto child_level = bottom_levels[child->id];
+            if (child->receives_bootstrapped_result_from(operation))
+            {
+                child_level += get_fastest_latency(operation, true);
+            }
+            max_child_level = std::max(max_child_level, child_level);
+        }
+        bottom_levels[operation->id] = get_fastest_latency(operation, false) + max_child_level;
+    }
+
+    int min_head = std::numeric_limits<int>::max();
+    int min_tail = std::numeric_limits<int>::max();
+    for (const auto operation : program)
+    {
+        if (!operation->is_bootstrapped())
+        {
+            continue;
+        }
+
+        int tail = 0;
+        for (const auto &child : operation->bootstrap_children)
+        {
+            tail = std::max(tail, bottom_levels[child->id]);
+        }
+        min_head = std::min(min_head, operation_finish_times[operation->id]);
+        min_tail = std::min(min_tail, tail);
+    }
+
+    if (bootstrap_work == 0)
+    {
+        return 0;
+    }
+
+    int num_bootstrap_cores = options.num_bootstrap_cores == 0 ? core_availability.size()
+                                                               : options.num_bootstrap_cores;
+    return min_head + std::ceil(bootstrap_work / num_bootstrap_cores) + min_tail;
+}
+
+int ListScheduler::get_fastest_latency(const OperationPtr &operation, bool is_bootstrap) const
+{
+    int fastest_latency = std::numeric_limits<int>::max();
+    for (const auto &[core_num, latencies] : core_latencies)
+    {
+        if (core_can_run(core_num, is_bootstrap))
+        {
+            fastest_latency = std::min(fastest_latency, get_latency_on_core(operation, is_bootstrap, core_num));
+        }
+    }
+    return fastest_latency;
+}
+
+// The busy intervals of every core, sorted by start time.
+std::map<int, std::vector<std::pair<int, int>>> ListScheduler::get_busy_intervals() const
+{
+    std::map<int, std::vector<std::pair<int, int>>> busy_intervals;
+    for (const auto &[core_num, available] : core_availability)
+    {
+        busy_intervals[core_num];
+    }
+    for (const auto operation : program)
+    {
+        busy_intervals[operation->core_num].push_back({operation->start_time, finish_times[operation->id]});
+        if (operation->is_bootstrapped())
+        {
+            busy_intervals[operation->bootstrap_core_num].push_back(
+                {operation->bootstrap_start_time, bootstrap_finish_times[operation->id]});
+        }
+    }
+    for (auto &[core_num, intervals] : busy_intervals)
+    {
+        std::ranges::sort(intervals);
+    }
+    return busy_intervals;
+}
+
+void ListScheduler::write_report_file(const std::string &filename) const
+{
+    std::ofstream file(filename);
+
+    auto bounds = get_lower_bounds();
+    auto lower_bound = std::max({bounds.critical_path, bounds.total_work, bounds.bootstrap_resource});
+    file << "makespan: " << solver_latency << std::endl;
+    file << "critical_path_bound: " << bounds.critical_path << std::endl;
+    file << "total_work_bound: " << bounds.total_work << std::endl;
+    file << "bootstrap_resource_bound: " << bounds.bootstrap_resource << std::endl;
+    file << "lower_bound: " << lower_bound << std::endl;
+    file << "efficiency: " << double(lower_bound) / std::max(solver_latency, 1) << std::endl;
+    file << std::endl;
+
+    // Idle gaps are binned by powers of two: [1, 2), [2, 4), [4, 8), ...
+    const int num_bins = 32;
+    auto busy_intervals = get_busy_intervals();
+    std::map<int, std::vector<int>> idle_histograms;
+    file << "core,utilization,busy_cycles,idle_cycles" << std::endl;
+    for (const auto &[core_num, intervals] : busy_intervals)
+    {
+        auto &histogram = idle_histograms[core_num];
+        histogram.assign(num_bins, 0);
+
+        int busy_cycles = 0;
+        int previous_finish_time = 0;
+        for (const auto &[start_time, finish_time] : intervals)
+        {
+            busy_cycles += finish_time - start_time;
+            auto gap = start_time - previous_finish_time;
+            if (gap > 0)
+            {
+                histogram[std::bit_width(unsigned(gap)) - 1]++;
+            }
+            previous_finish_time = finish_time;
+        }
+        auto final_gap = solver_latency - previous_finish_time;
+        if (final_gap > 0)
+        {
+            histogram[std::bit_width(unsigned(final_gap)) - 1]++;
+        }
+
+        file << core_num << ","
+             << double(busy_cycles) / std::max(solver_latency, 1) << ","
+             << busy_cycles << ","
+             << solver_latency - busy_cycles << std::endl;
+    }
+    file << std::endl;
+
+    file << "idle_gap_cycles";
+    for (const auto &[core_num, histogram] : idle_histograms)
+    {
+        file << ",core_" << core_num;
+    }
+    file << std::endl;
+    for (int bin = 0; bin < num_bins; bin++)
+    {
+        if (std::ranges::none_of(idle_histograms, [bin](const auto &entry)
+                                 { return entry.second[bin] > 0; }))
+        {
+            continue;
+        }
+        file << (1 << bin) << "-" << (2 << bin) - 1;
+        for (const auto &[core_num, histogram] : idle_histograms)
+        {
+            file << "," << histogram[bin];
+        }
+        file << std::endl;
+    }
 }
 
 std::string ListScheduler::get_log_filename() const
@@ -293,6 +1335,63 @@ std::string ListScheduler::get_log_filename() const
     return options.output_filename + ".log";
 }
 
+bool ListScheduler::is_thread_count_sweep() const
+{
+    return options.thread_counts.size() > 1;
+}
+
+// Schedules the program once per thread count, in parallel. Every count
+// gets its own copy of the parsed program and writes its own
+// <output_file>_t<count> files.
+void ListScheduler::perform_thread_count_sweep()
+{
+    std::vector<std::unique_ptr<ListScheduler>> schedulers;
+    for (auto num_threads : options.thread_counts)
+    {
+        auto sweep_options = options;
+        sweep_options.num_threads = num_threads;
+        sweep_options.thread_counts = {num_threads};
+        sweep_options.output_filename += "_t" + std::to_string(num_threads);
+        schedulers.emplace_back(new ListScheduler(sweep_options, program));
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < schedulers.size(); i++)
+    {
+        schedulers[i]->perform_list_scheduling();
+        schedulers[i]->write_to_output_files();
+    }
+
+    std::ofstream file(options.output_filename + "_sweep.csv");
+    file << "num_threads,makespan,lower_bound,peak_live_ciphertexts" << std::endl;
+    for (const auto &scheduler : schedulers)
+    {
+        auto bounds = scheduler->get_lower_bounds();
+        file << scheduler->options.num_threads << ","
+             << scheduler->solver_latency << ","
+             << std::max({bounds.critical_path, bounds.total_work, bounds.bootstrap_resource}) << ","
+             << scheduler->peak_live_ciphertexts << std::endl;
+    }
+}
+
+// Accepts a single count, a comma separated list, and inclusive ranges,
+// e.g. "8", "1,2,4,8", or "1-4,8".
+std::vector<int> ListScheduler::parse_thread_counts(const std::string &thread_counts_string)
+{
+    std::vector<int> thread_counts;
+    for (const auto &item : utl::split_string_by_character(thread_counts_string, ','))
+    {
+        auto range = utl::split_string_by_character(item, '-');
+        auto first = std::stoi(range.front());
+        auto last = std::stoi(range.back());
+        for (int num_threads = first; num_threads <= last; num_threads++)
+        {
+            thread_counts.push_back(num_threads);
+        }
+    }
+    return thread_counts;
+}
+
 int main(int argc, char **argv)
 {
     ListScheduler list_scheduler = ListScheduler(argc, argv);
@@ -301,11 +1400,21 @@ int main(int argc, char **argv)
 
     std::function<void()> main_func = [&list_scheduler]()
     {
+        if (list_scheduler.is_thread_count_sweep())
+        {
+            list_scheduler.perform_thread_count_sweep();
+            return;
+        }
         list_scheduler.perform_list_scheduling();
         list_scheduler.write_to_output_files();
     };
 
     utl::perform_func_and_print_execution_time(main_func, log_file);
 
+    if (!list_scheduler.is_thread_count_sweep())
+    {
+        log_file << list_scheduler.get_peak_live_ciphertexts() << std::endl;
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -1,11 +1,17 @@
 #include "shared_utils.h"
 #include "program.h"
 #include "file_writer.h"
+#include "priority_policy.h"
+#include "machine.h"
+#include "transfer_latencies.h"
+#include "contention_curve.h"
 
 #include <vector>
 #include <map>
 #include <unordered_set>
 #include <numeric>
+#include <bit>
+#include <ranges>
 
 class ListScheduler
 {
@@ -17,6 +23,9 @@ public:
   void write_to_output_files() const;
 
   std::string get_log_filename() const;
+  int get_peak_live_ciphertexts() const;
+  bool is_thread_count_sweep() const;
+  void perform_thread_count_sweep();
 
 private:
   const std::string help_info = R"(
@@ -24,17 +33,102 @@ Usage: ./list_scheduler.out <dag_file>
                             <output_file>
                             [<options>]
 
+Writes <output_file>.lgr, <output_file>.sched, and <output_file>_report.txt.
+The report holds lower bounds on the makespan (critical path with the
+chosen bootstraps, total work over the cores, and bootstrap work over
+the cores that may bootstrap), along with per-core utilization and a
+histogram of idle gaps on every core.
+
 Options:
   -l <file>, --latency-file=<file>
     A file describing the latencies of FHE operations on the target
     hardware. The default values can be found in program.h.
-  -t <int>, --num-threads=<int>
+    Lines of the form <type>,<levels>,<latency> give the latency of an
+    operation whose inputs have <levels> levels left. The largest listed
+    level is the level of fresh and bootstrapped ciphertexts.
+  -t <int/list>, --num-threads=<int/list>
     The number of threads on which operations may be scheduled.
-    Defaults to 1.
+    Defaults to 1. A comma separated list of counts and inclusive
+    ranges, e.g. 1,2,4,8 or 1-4,8, schedules every count in parallel,
+    writes each schedule to <output_file>_t<count>, and writes the
+    makespan of every count to <output_file>_sweep.csv.
+  -M <file>, --machine-file=<file>
+    A file describing a heterogeneous machine as a list of core
+    classes. Each class starts with a "CLASS,<name>,<count>" line,
+    followed by "<type>,<latency>" lines for ADD, SUB, MUL, and BOOT.
+    Types a class does not list use the latency file values. Cores are
+    numbered in the order the classes are listed, and -t is ignored.
+    Each task is placed on the core where it finishes earliest, waiting
+    for a busy core if that is still faster.
+  -x <file>, --transfer-latency-file=<file>
+    A comma separated matrix where row i, column j is the number of
+    cycles needed to move a ciphertext from core i to core j. A matrix
+    with fewer rows than cores is read per socket, with the cores split
+    into equally sized, consecutive sockets. Tasks start once their
+    inputs have reached their core, and cores are chosen to minimize
+    the finish time including these transfers. Defaults to free
+    transfers.
+  -C <file>, --contention-file=<file>
+    A file describing how BOOT and MUL slow down when several of them
+    run at once. Each line is "<type>,<num_concurrent>,<slowdown>",
+    where <num_concurrent> counts all running BOOT and MUL tasks and
+    <slowdown> multiplies the uncontended latency. Values between the
+    listed points are interpolated. Finish times are recomputed as the
+    number of running tasks changes, and a BOOT or MUL is held back when
+    starting it would lower the combined throughput. Defaults to no
+    contention.
+  -c <int>, --max-live-ciphertexts=<int>
+    The largest number of ciphertexts, bootstrapped copies included,
+    that may be live at once. A value is live from the start of the
+    task that creates it until its last consumer finishes. At the cap,
+    only tasks that are the last reader of one of their inputs may
+    start, so the peak may exceed the cap by up to the number of cores.
+    The peak live count is written to the log file. Defaults to 0,
+    meaning unlimited.
+  -b <int>, --bootstrap-cores=<int>
+    The number of cores dedicated to bootstrapping. When greater than
+    0, bootstraps only run on these cores and all other operations
+    only run on the -t general cores. The bootstrap cores are numbered
+    after the general cores, from <num_threads>+1, in both the B2C
+    lines of the .lgr file and the threads of the .sched file.
+    Defaults to 0, meaning every core may bootstrap.
   -i <file/"NULL">, --input-lgr=<file/"NULL">
     A path to a .lgr file specifying a set of operations to bootstrap.
     Setting to "NULL" means scheduling will be performed without
-    bootstrapping. Defaults to "NULL".)";
+    bootstrapping. Defaults to "NULL".
+  -L <int>, --num-levels=<int>
+    Places bootstraps while scheduling instead of reading them from
+    -i. Every fresh ciphertext has this many levels and every MUL uses
+    one. When an operation finishes, its result is bootstrapped for the
+    children on a path with more MULs than it has levels left. This
+    happens at the latest when a MUL child would run out of levels, and
+    one level earlier when a single bootstrap would serve several
+    children. The chosen pairs are written to the .lgr file. Defaults
+    to 0, meaning off.
+  -p <policy>, --priority=<policy>
+    The order in which ready operations and bootstraps are started.
+    Each bootstrap is its own task and may run on any free core. Ties
+    are broken by operation id. Defaults to SLACK.
+      SLACK: Least slack first.
+      RANK: Largest upward rank first, i.e. the longest path from the
+        operation to the end of the program, bootstraps included.
+      DESCENDANTS: Most descendant operations first.
+      BOOTSTRAP_FIRST: Bootstrapped operations first, then least slack.
+      WEIGHTED,<s>,<r>,<d>,<b>: Weighted sum of the slack, upward rank,
+        descendants, and is-bootstrapped terms above, each normalized
+        to [0, 1]. Higher r, d, and b values favor those operations.
+  -T <float>, --time-budget=<float>
+    A wall-clock budget in seconds. When given, the schedule is
+    refined by simulated annealing until the budget expires, and the
+    shortest schedule found is written. Each step redraws or swaps
+    task priorities, or swaps the cores of two tasks, and simulates
+    the result. The makespan over time is written to
+    <output_file>_quality.csv.
+  -n <int>, --iterations=<int>
+    An iteration budget for the refinement above. Can be given with
+    or without -T. With -n alone, results only depend on the seed.
+  -s <int>, --seed=<int>
+    The seed of the refinement. Defaults to 1.)";
 
   struct Options
   {
@@ -43,60 +137,229 @@ Options:
     std::string output_filename;
     std::string bootstrap_filename = "NULL";
     int num_threads = 1;
+    std::vector<int> thread_counts = {1};
+    int num_bootstrap_cores = 0;
+    std::string machine_filename;
+    std::string transfer_latency_filename;
+    int max_live_ciphertexts = 0;
+    std::string contention_filename;
+    std::string priority_policy_string = "SLACK";
+    utl::TimeBudget time_budget;
+    int max_iterations = 0;
+    int num_levels = 0;
+    unsigned seed = 1;
   } options;
 
+  std::unique_ptr<PriorityPolicy> priority_policy;
+
   int solver_latency;
 
   std::unordered_map<int, bool> core_availability;
+  std::unordered_map<int, LatencyMap> core_latencies;
+  std::unordered_map<int, int> core_finish_times;
+  TransferLatencies transfer_latencies;
+  ContentionCurve contention_curve;
+
+  // Indexed by operation id. The number of unfinished tasks that read
+  // c<id> and c0<id> respectively.
+  std::vector<int> remaining_uses;
+  std::vector<int> remaining_bootstrapped_uses;
+  int num_live_ciphertexts = 0;
+  int peak_live_ciphertexts = 0;
+
+  // Indexed by operation id. Used when bootstraps are placed during
+  // scheduling.
+  std::vector<int> remaining_levels;
+  std::vector<int> levels_needed;
 
   Program program;
 
+  // Indexed by operation id. Lower values are scheduled first.
+  std::vector<double> priorities;
+  std::vector<double> bootstrap_priorities;
+  // Indexed by operation id. Cores picked during refinement, 0 if none.
+  std::vector<int> preferred_cores;
+  std::vector<int> preferred_bootstrap_cores;
+
   struct PriorityCmp
   {
+    std::reference_wrapper<const std::vector<double>> priorities_ref;
+
     bool operator()(const OperationPtr &a, const OperationPtr &b) const
     {
-      auto a_slack = a->get_slack();
-      auto b_slack = b->get_slack();
-      if (a_slack == b_slack)
+      const auto &priorities = priorities_ref.get();
+      auto a_priority = priorities[a->id];
+      auto b_priority = priorities[b->id];
+      if (a_priority == b_priority)
       {
         return a->id < b->id;
       }
       else
       {
-        return a_slack < b_slack;
+        return a_priority < b_priority;
       }
     }
   };
 
+  // A ready unit of work: either an operation or the bootstrap of its result.
+  struct Task
+  {
+    OperationPtr operation;
+    bool is_bootstrap;
+  };
+
+  struct TaskPriorityCmp
+  {
+    std::reference_wrapper<const std::vector<double>> priorities_ref;
+    std::reference_wrapper<const std::vector<double>> bootstrap_priorities_ref;
+
+    double get_priority(const Task &task) const
+    {
+      const auto &task_priorities = task.is_bootstrap
+                                        ? bootstrap_priorities_ref.get()
+                                        : priorities_ref.get();
+      return task_priorities[task.operation->id];
+    }
+
+    bool operator()(const Task &a, const Task &b) const
+    {
+      auto a_priority = get_priority(a);
+      auto b_priority = get_priority(b);
+      if (a_priority != b_priority)
+      {
+        return a_priority < b_priority;
+      }
+      else if (a.operation->id != b.operation->id)
+      {
+        return a.operation->id < b.operation->id;
+      }
+      else
+      {
+        return a.is_bootstrap < b.is_bootstrap;
+      }
+    }
+  };
+
+  struct OperationPlacement
+  {
+    int start_time;
+    int core_num;
+    int bootstrap_start_time;
+    int bootstrap_core_num;
+    int finish_time;
+    int bootstrap_finish_time;
+    OpSet bootstrap_children;
+  };
+
+  // A point of the refinement search. The placements are those of the
+  // schedule the state produced.
+  struct SearchState
+  {
+    std::vector<double> priorities;
+    std::vector<double> bootstrap_priorities;
+    std::vector<int> preferred_cores;
+    std::vector<int> preferred_bootstrap_cores;
+    std::vector<OperationPlacement> placements;
+  };
+
+  struct LowerBounds
+  {
+    int critical_path = 0;
+    int total_work = 0;
+    int bootstrap_resource = 0;
+  };
+
   std::map<OperationPtr, int> pred_count;
-  std::map<OperationPtr, int> running_operations;
-  std::map<OperationPtr, int> bootstrapping_operations;
-  std::set<OperationPtr, PriorityCmp> prioritized_unstarted_operations;
-  OpVector ready_operations;
+  // The work left on a started task, in cycles of an uncontended core.
+  // The task computes from start_time on.
+  struct TaskProgress
+  {
+    int start_time;
+    double work_left;
+    OperationType::Type type;
+    int core_num;
+  };
+
+  std::map<OperationPtr, TaskProgress> running_operations;
+  std::map<OperationPtr, TaskProgress> bootstrapping_operations;
+  // Indexed by operation id.
+  std::vector<int> finish_times;
+  std::vector<int> bootstrap_finish_times;
+  std::set<OperationPtr, PriorityCmp> prioritized_unstarted_operations{PriorityCmp{priorities}};
+  std::set<Task, TaskPriorityCmp> ready_tasks{TaskPriorityCmp{priorities, bootstrap_priorities}};
   int clock_cycle;
-  int bootstrap_latency;
 
   OpSet finished_running_operations;
   OpSet finished_bootstrapping_operations;
 
   void run_simulation();
+  void initialize_priorities();
+  void refine_schedule();
+  bool refinement_budget_expired(int) const;
+  double get_refinement_progress(int) const;
+  void perturb_search_state(SearchState &, const std::vector<OperationPlacement> &, std::minstd_rand &) const;
+  void apply_search_state(const SearchState &);
+  std::vector<OperationPlacement> get_placements() const;
+  void apply_placements(const std::vector<OperationPlacement> &);
+
+  LowerBounds get_lower_bounds() const;
+  int get_bootstrap_resource_bound(const std::vector<int> &, double) const;
+  int get_fastest_latency(const OperationPtr &, bool) const;
+  std::map<int, std::vector<std::pair<int, int>>> get_busy_intervals() const;
+  void write_report_file(const std::string &) const;
 
   void initialize_pred_count();
   void update_ready_operations();
-  OpSet handle_started_operations(std::map<OperationPtr, int> &);
-  void decrement_cycles_left(std::map<OperationPtr, int> &);
-  OpSet get_finished_operations(std::map<OperationPtr, int> &);
-  void start_ready_operations();
-  void start_bootstrapping_necessary_operations();
+  OpSet handle_started_operations(std::map<OperationPtr, TaskProgress> &, std::vector<int> &, int);
+  void advance_started_operations(std::map<OperationPtr, TaskProgress> &, int);
+  OpSet get_finished_operations(std::map<OperationPtr, TaskProgress> &);
+  int get_num_contending_tasks(bool) const;
+  bool contention_allows(OperationType::Type) const;
+  void update_core_finish_time_estimates();
+  void start_ready_tasks();
+  void start_operation(const OperationPtr &, int);
+  void start_bootstrap(const OperationPtr &, int);
+  void queue_bootstraps_of_finished_operations();
+  void reset_bootstraps();
+  void initialize_levels_needed();
+  void choose_bootstraps_of_finished_operations();
+  int get_input_levels(const OperationPtr &) const;
+  int get_remaining_levels(const OperationPtr &) const;
   void mark_cores_available(const OpSet &);
+  void mark_bootstrap_cores_available(const OpSet &);
   void update_pred_count();
   void initialize_simulation_state();
   void update_simulation_state();
   void parse_args(int, char **);
 
   int get_best_core_for_operation(const OperationPtr &, int) const;
-  int get_available_core_num() const;
+  int get_best_core_for_bootstrap(const OperationPtr &, int) const;
+  ListScheduler(const Options &, const Program &);
+
+  static std::vector<int> parse_thread_counts(const std::string &);
+  void initialize_cores();
+  void add_cores_from_machine_file();
+  void add_core(int, const LatencyMap &);
+  void occupy_core(int, int);
+  void initialize_ciphertext_uses();
+  bool live_ciphertext_cap_allows(const OperationPtr &, bool) const;
+  bool releases_an_input(const OperationPtr &, bool) const;
+  void add_live_ciphertext();
+  void release_consumed_ciphertexts();
+  void release_ciphertext_use(const OperationPtr &, bool);
+  std::unordered_map<int, int> get_core_ready_times() const;
+  std::pair<int, int> get_earliest_finish_core(const OperationPtr &, bool, const std::unordered_map<int, int> &) const;
+  int operation_core(const OperationPtr &, bool) const;
+  int get_latency_on_core(const OperationPtr &, bool, int) const;
+  bool preferred_core_is_usable(int, bool) const;
+  bool finishes_no_later_on(const OperationPtr &, bool, int, int) const;
+  int get_finish_time_on_core(const OperationPtr &, bool, int, int) const;
+  int get_input_ready_time(const OperationPtr &, bool, int) const;
+  int get_result_ready_time(const OperationPtr &, bool) const;
+  OperationType::Type get_task_type(const OperationPtr &, bool) const;
+  bool any_core_is_available() const;
   bool core_is_available(int) const;
+  bool core_can_run(int, bool) const;
   bool program_is_not_finished() const;
   void print_options() const;
 };
\ No newline at end of file
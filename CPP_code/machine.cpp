@@ -0,0 +1,78 @@
+#include "machine.h"
+
+Machine::Machine(const std::string &filename, const LatencyMap &default_latencies)
+{
+    parse_machine_file(filename, default_latencies);
+
+    if (get_num_cores() <= 0)
+    {
+        std::cout << "Machine file " << filename << " describes no cores." << std::endl;
+        exit(1);
+    }
+}
+
+void Machine::parse_machine_file(const std::string &filename, const LatencyMap &default_latencies)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        std::cout << "Could not open machine file " << filename << std::endl;
+        exit(1);
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        utl::trim(line);
+        if (line.empty())
+        {
+            continue;
+        }
+
+        auto line_as_list = utl::split_string_by_character(line, ',');
+        if (line_as_list[0] == "CLASS")
+        {
+            parse_class_line(line_as_list, default_latencies);
+        }
+        else
+        {
+            parse_latency_line(line_as_list);
+        }
+    }
+}
+
+void Machine::parse_class_line(const std::vector<std::string> &line_as_list, const LatencyMap &default_latencies)
+{
+    if (line_as_list.size() != 3)
+    {
+        std::cout << "Invalid core class line, expected CLASS,<name>,<count>." << std::endl;
+        exit(1);
+    }
+    core_classes.push_back({line_as_list[1], std::stoi(line_as_list[2]), default_latencies});
+}
+
+void Machine::parse_latency_line(const std::vector<std::string> &line_as_list)
+{
+    if (core_classes.empty())
+    {
+        std::cout << "Latencies in a machine file must follow a CLASS line." << std::endl;
+        exit(1);
+    }
+    auto type = OperationType(line_as_list[0]);
+    core_classes.back().latencies.scale_latency(type, std::stoi(line_as_list[1]));
+}
+
+const std::vector<Machine::CoreClass> &Machine::get_core_classes() const
+{
+    return core_classes;
+}
+
+int Machine::get_num_cores() const
+{
+    int num_cores = 0;
+    for (const auto &core_class : core_classes)
+    {
+        num_cores += core_class.num_cores;
+    }
+    return num_cores;
+}
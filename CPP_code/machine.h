@@ -0,0 +1,41 @@
+#ifndef machine_INCLUDED_
+#define machine_INCLUDED_
+
+#include "operation.h"
+#include "shared_utils.h"
+
+// A machine made of classes of identical cores. Each class has its own
+// latency for every operation type. Level-resolved latencies of a type
+// are scaled by the ratio of the class latency to the default one.
+//
+// File format:
+//   CLASS,<name>,<count>
+//   <type>,<latency>
+//   ...
+//   CLASS,<name>,<count>
+//   ...
+class Machine
+{
+public:
+    struct CoreClass
+    {
+        std::string name;
+        int num_cores;
+        LatencyMap latencies;
+    };
+
+    Machine(){};
+    Machine(const std::string &, const LatencyMap &);
+
+    const std::vector<CoreClass> &get_core_classes() const;
+    int get_num_cores() const;
+
+private:
+    std::vector<CoreClass> core_classes;
+
+    void parse_machine_file(const std::string &, const LatencyMap &);
+    void parse_class_line(const std::vector<std::string> &, const LatencyMap &);
+    void parse_latency_line(const std::vector<std::string> &);
+};
+
+#endif
@@ -1,12 +1,113 @@
 #include "operation.h"
 
+#include <algorithm>
+#include <cmath>
+
+LatencyMap::LatencyMap(std::initializer_list<std::pair<const OperationType::Type, int>> type_latencies)
+    : latencies(type_latencies) {}
+
+int LatencyMap::at(OperationType::Type type) const
+{
+    return latencies.at(type);
+}
+
+int LatencyMap::at(OperationType::Type type, int level) const
+{
+    auto type_it = level_latencies.find(type);
+    if (level < 0 || type_it == level_latencies.end())
+    {
+        return latencies.at(type);
+    }
+
+    auto level_it = type_it->second.find(level);
+    return level_it == type_it->second.end() ? latencies.at(type) : level_it->second;
+}
+
+// The latency of the type at the level where it is fastest.
+int LatencyMap::get_fastest(OperationType::Type type) const
+{
+    auto fastest_latency = latencies.at(type);
+    if (level_latencies.contains(type))
+    {
+        for (const auto &[level, latency] : level_latencies.at(type))
+        {
+            fastest_latency = std::min(fastest_latency, latency);
+        }
+    }
+    return fastest_latency;
+}
+
+bool LatencyMap::is_level_resolved() const
+{
+    return !level_latencies.empty();
+}
+
+// The number of levels of a fresh or bootstrapped ciphertext.
+int LatencyMap::get_max_level() const
+{
+    int max_level = 0;
+    for (const auto &[type, type_level_latencies] : level_latencies)
+    {
+        max_level = std::max(max_level, type_level_latencies.rbegin()->first);
+    }
+    return max_level;
+}
+
+void LatencyMap::set_latency(OperationType::Type type, int latency)
+{
+    latencies[type] = latency;
+}
+
+void LatencyMap::set_level_latency(OperationType::Type type, int level, int latency)
+{
+    level_latencies[type][level] = latency;
+}
+
+// Sets the latency of the type and scales its level latencies by the
+// same factor, so they keep their shape on a core that is uniformly
+// faster or slower.
+void LatencyMap::scale_latency(OperationType::Type type, int latency)
+{
+    auto old_latency = latencies.at(type);
+    latencies[type] = latency;
+    if (!level_latencies.contains(type) || old_latency == 0)
+    {
+        return;
+    }
+
+    for (auto &[level, level_latency] : level_latencies.at(type))
+    {
+        level_latency = std::max(1L, std::lround(double(level_latency) * latency / old_latency));
+    }
+}
+
 Operation::Operation(OperationType type, int id) : type{type}, id{id} {}
 
+// A multiplication uses one of the levels of its inputs.
+int Operation::get_result_level() const
+{
+    if (level < 0)
+    {
+        return level;
+    }
+    return std::max(0, level - (type == OperationType::MUL ? 1 : 0));
+}
+
+int Operation::get_latency(const LatencyMap &latencies) const
+{
+    return latencies.at(type, level);
+}
+
+int Operation::get_bootstrap_latency(const LatencyMap &latencies) const
+{
+    return latencies.at(OperationType::BOOT, get_result_level());
+}
+
 int Operation::get_total_latency(const LatencyMap &latencies) const
 {
-    auto pre_bootstrap_latency = latencies.at(type);
+    auto pre_bootstrap_latency = get_latency(latencies);
     auto bootstrap_latency = is_bootstrapped()
-                                 ? latencies.at(OperationType::BOOT)
+                                 ? get_bootstrap_latency(latencies)
                                  : 0;
 
     return pre_bootstrap_latency + bootstrap_latency;
@@ -60,7 +161,6 @@ void Operation::update_earliest_start_and_finish_times(const LatencyMap &latenci
 {
     earliest_start_time = 0;
 
-    auto bootstrap_latency = latencies.at(OperationType::BOOT);
     for (auto parent : parent_ptrs)
     {
         earliest_start_time = std::max(earliest_start_time, parent->earliest_finish_time);
@@ -16,7 +16,30 @@ using OperationPtr = Operation *;
 using OpVector = std::vector<OperationPtr>;
 using OpSet = std::unordered_set<OperationPtr>;
 
-using LatencyMap = std::map<OperationType::Type, int>;
+// The latency of every operation type. A type may also have latencies
+// for a number of levels left on its inputs, which are used for
+// operations whose level is known. Levels without a latency of their own
+// fall back to the latency of the type.
+class LatencyMap
+{
+public:
+    LatencyMap(){};
+    LatencyMap(std::initializer_list<std::pair<const OperationType::Type, int>>);
+
+    int at(OperationType::Type) const;
+    int at(OperationType::Type, int) const;
+    int get_fastest(OperationType::Type) const;
+    bool is_level_resolved() const;
+    int get_max_level() const;
+
+    void set_latency(OperationType::Type, int);
+    void set_level_latency(OperationType::Type, int, int);
+    void scale_latency(OperationType::Type, int);
+
+private:
+    std::map<OperationType::Type, int> latencies;
+    std::map<OperationType::Type, std::map<int, int>> level_latencies;
+};
 
 struct Operation
 {
@@ -34,6 +57,9 @@ public:
     int start_time;
     int bootstrap_start_time = 0;
     int core_num = 0;
+    // The number of levels left on the inputs, or -1 when unknown.
+    int level = -1;
+    int bootstrap_core_num = 0;
     int num_unsatisfied_segments = 0;
     double bootstrap_urgency = 0;
     int earliest_finish_time;
@@ -42,6 +68,9 @@ public:
 
     Operation(OperationType type, int id);
 
+    int get_result_level() const;
+    int get_latency(const LatencyMap &) const;
+    int get_bootstrap_latency(const LatencyMap &) const;
     int get_total_latency(const LatencyMap &) const;
     int get_slack() const;
 
@@ -0,0 +1,242 @@
+#include "priority_policy.h"
+
+#include <bit>
+#include <ranges>
+
+std::unique_ptr<PriorityPolicy> PriorityPolicy::create(const std::string &policy_string)
+{
+    auto policy_list = utl::split_string_by_character(policy_string, ',');
+    const auto &name = policy_list.at(0);
+
+    if (name == "SLACK")
+    {
+        return std::make_unique<SlackPolicy>();
+    }
+    else if (name == "RANK")
+    {
+        return std::make_unique<UpwardRankPolicy>();
+    }
+    else if (name == "DESCENDANTS")
+    {
+        return std::make_unique<DescendantsPolicy>();
+    }
+    else if (name == "BOOTSTRAP_FIRST")
+    {
+        return std::make_unique<BootstrapFirstPolicy>();
+    }
+    else if (name == "WEIGHTED")
+    {
+        if (policy_list.size() != 5)
+        {
+            throw std::invalid_argument("WEIGHTED requires four weights.");
+        }
+        return std::make_unique<WeightedPolicy>(WeightedPolicy::Weights{
+            std::stod(policy_list[1]),
+            std::stod(policy_list[2]),
+            std::stod(policy_list[3]),
+            std::stod(policy_list[4])});
+    }
+
+    throw std::invalid_argument(name + " is not a valid priority policy.");
+}
+
+std::vector<double> PriorityPolicy::get_bootstrap_priorities(const Program &program) const
+{
+    return get_priorities(program);
+}
+
+std::vector<double> SlackPolicy::get_priorities(const Program &program) const
+{
+    std::vector<double> priorities(program.size() + 1);
+    for (const auto operation : program)
+    {
+        priorities[operation->id] = operation->get_slack();
+    }
+    return priorities;
+}
+
+std::string SlackPolicy::to_string() const
+{
+    return "SLACK";
+}
+
+std::vector<double> UpwardRankPolicy::get_priorities(const Program &program) const
+{
+    auto priorities = get_upward_ranks(program);
+    for (auto &priority : priorities)
+    {
+        priority = -priority;
+    }
+    return priorities;
+}
+
+// The rank of a bootstrap task is its own latency plus the largest rank
+// among the children that receive the bootstrapped result.
+std::vector<double> UpwardRankPolicy::get_bootstrap_priorities(const Program &program) const
+{
+    auto ranks = get_upward_ranks(program);
+
+    std::vector<double> priorities(program.size() + 1);
+    for (const auto operation : program)
+    {
+        double max_child_rank = 0;
+        for (const auto &child : operation->bootstrap_children)
+        {
+            max_child_rank = std::max(max_child_rank, ranks[child->id]);
+        }
+        priorities[operation->id] = -(program.get_bootstrap_latency_of(operation) + max_child_rank);
+    }
+    return priorities;
+}
+
+std::string UpwardRankPolicy::to_string() const
+{
+    return "RANK";
+}
+
+std::vector<double> UpwardRankPolicy::get_upward_ranks(const Program &program)
+{
+    std::vector<double> ranks(program.size() + 1);
+    std::ranges::reverse_view reverse_program{program};
+    for (const auto operation : reverse_program)
+    {
+        double max_child_rank = 0;
+        for (const auto &child : operation->child_ptrs)
+        {
+            auto child_rank = ranks[child->id];
+            if (child->receives_bootstrapped_result_from(operation))
+            {
+                child_rank += program.get_bootstrap_latency_of(operation);
+            }
+            max_child_rank = std::max(max_child_rank, child_rank);
+        }
+        ranks[operation->id] = program.get_latency_of(operation) + max_child_rank;
+    }
+    return ranks;
+}
+
+std::vector<double> DescendantsPolicy::get_priorities(const Program &program) const
+{
+    auto priorities = get_num_descendants(program);
+    for (auto &priority : priorities)
+    {
+        priority = -priority;
+    }
+    return priorities;
+}
+
+std::string DescendantsPolicy::to_string() const
+{
+    return "DESCENDANTS";
+}
+
+// Operations are numbered in topological order, so a reverse sweep over the
+// ids propagates reachability from children to parents. Each sweep tracks a
+// block of 64 target operations as one bit per operation, keeping memory
+// linear in the program size.
+std::vector<double> DescendantsPolicy::get_num_descendants(const Program &program)
+{
+    const int num_operations = program.size();
+    const int block_size = 64;
+    const int num_blocks = (num_operations + block_size - 1) / block_size;
+
+    std::vector<double> num_descendants(num_operations + 1);
+
+#pragma omp parallel
+    {
+        std::vector<uint64_t> reaches(num_operations + 1);
+        std::vector<int> local_num_descendants(num_operations + 1);
+
+#pragma omp for schedule(dynamic)
+        for (int block = 0; block < num_blocks; block++)
+        {
+            const int block_start = block * block_size + 1;
+            const int last_id = std::min(num_operations, block_start + block_size - 1);
+            std::fill(reaches.begin() + last_id + 1, reaches.end(), 0);
+            for (int id = last_id; id >= 1; id--)
+            {
+                uint64_t bits = 0;
+                for (const auto &child : program.get_operation_ptr_from_id(id)->child_ptrs)
+                {
+                    bits |= reaches[child->id];
+                }
+                local_num_descendants[id] += std::popcount(bits);
+                if (id >= block_start)
+                {
+                    bits |= uint64_t(1) << (id - block_start);
+                }
+                reaches[id] = bits;
+            }
+        }
+
+#pragma omp critical
+        for (int id = 1; id <= num_operations; id++)
+        {
+            num_descendants[id] += local_num_descendants[id];
+        }
+    }
+
+    return num_descendants;
+}
+
+std::vector<double> BootstrapFirstPolicy::get_priorities(const Program &program) const
+{
+    auto priorities = SlackPolicy().get_priorities(program);
+    const double bootstrap_offset = program.get_maximum_slack() + 1;
+    for (const auto operation : program)
+    {
+        if (operation->is_bootstrapped())
+        {
+            priorities[operation->id] -= bootstrap_offset;
+        }
+    }
+    return priorities;
+}
+
+std::string BootstrapFirstPolicy::to_string() const
+{
+    return "BOOTSTRAP_FIRST";
+}
+
+WeightedPolicy::WeightedPolicy(const Weights &weights) : weights{weights} {}
+
+std::vector<double> WeightedPolicy::get_priorities(const Program &program) const
+{
+    auto slacks = SlackPolicy().get_priorities(program);
+    auto ranks = UpwardRankPolicy::get_upward_ranks(program);
+    auto num_descendants = DescendantsPolicy::get_num_descendants(program);
+    normalize(slacks);
+    normalize(ranks);
+    normalize(num_descendants);
+
+    std::vector<double> priorities(program.size() + 1);
+    for (const auto operation : program)
+    {
+        auto id = operation->id;
+        priorities[id] = weights.slack * slacks[id] -
+                         weights.rank * ranks[id] -
+                         weights.descendants * num_descendants[id] -
+                         weights.bootstrap * operation->is_bootstrapped();
+    }
+    return priorities;
+}
+
+std::string WeightedPolicy::to_string() const
+{
+    std::ostringstream stream;
+    stream << "WEIGHTED," << weights.slack << "," << weights.rank << ","
+           << weights.descendants << "," << weights.bootstrap;
+    return stream.str();
+}
+
+void WeightedPolicy::normalize(std::vector<double> &values)
+{
+    auto max = std::ranges::max(values);
+    if (max > 0)
+    {
+        for (auto &value : values)
+        {
+            value /= max;
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef priority_policy_INCLUDED_
+#define priority_policy_INCLUDED_
+
+#include "program.h"
+
+// A priority policy maps every operation to a number, indexed by operation
+// id. The list scheduler starts ready operations with lower values first.
+// Priorities are computed once per schedule, so policies may be expensive.
+class PriorityPolicy
+{
+public:
+    virtual ~PriorityPolicy() = default;
+
+    virtual std::vector<double> get_priorities(const Program &) const = 0;
+    // Priorities of the bootstrap tasks, indexed by the bootstrapped
+    // operation's id. Defaults to the operation's own priority.
+    virtual std::vector<double> get_bootstrap_priorities(const Program &) const;
+    virtual std::string to_string() const = 0;
+
+    static std::unique_ptr<PriorityPolicy> create(const std::string &);
+};
+
+class SlackPolicy : public PriorityPolicy
+{
+public:
+    std::vector<double> get_priorities(const Program &) const override;
+    std::string to_string() const override;
+};
+
+// The HEFT upward rank: the length of the longest path from the start of an
+// operation to the end of the program, including bootstrapping latencies on
+// the edges that receive a bootstrapped result.
+class UpwardRankPolicy : public PriorityPolicy
+{
+public:
+    std::vector<double> get_priorities(const Program &) const override;
+    std::vector<double> get_bootstrap_priorities(const Program &) const override;
+    std::string to_string() const override;
+
+    static std::vector<double> get_upward_ranks(const Program &);
+};
+
+class DescendantsPolicy : public PriorityPolicy
+{
+public:
+    std::vector<double> get_priorities(const Program &) const override;
+    std::string to_string() const override;
+
+    static std::vector<double> get_num_descendants(const Program &);
+};
+
+class BootstrapFirstPolicy : public PriorityPolicy
+{
+public:
+    std::vector<double> get_priorities(const Program &) const override;
+    std::string to_string() const override;
+};
+
+class WeightedPolicy : public PriorityPolicy
+{
+public:
+    struct Weights
+    {
+        double slack;
+        double rank;
+        double descendants;
+        double bootstrap;
+    };
+
+    WeightedPolicy(const Weights &);
+
+    std::vector<double> get_priorities(const Program &) const override;
+    std::string to_string() const override;
+
+private:
+    Weights weights;
+
+    static void normalize(std::vector<double> &);
+};
+
+#endif
@@ -18,6 +18,69 @@ Program::Program(const ConstructorInput &in)
     {
         file_parser.parse_latency_file(in.latency_filename);
     }
+
+    update_operation_levels();
+}
+
+Program::Program(const Program &other)
+    : bootstrap_segments(other.bootstrap_segments),
+      unsatisfied_bootstrap_segment_indexes(other.unsatisfied_bootstrap_segment_indexes),
+      alive_bootstrap_segment_indexes(other.alive_bootstrap_segment_indexes),
+      latencies(other.latencies),
+      mode(other.mode)
+{
+    for (const auto operation : other.operations)
+    {
+        operation_ptrs.push_back(std::make_unique<Operation>(*operation));
+        operations.push_back(operation_ptrs.back().get());
+    }
+
+    for (auto operation : operations)
+    {
+        for (auto &parent : operation->parent_ptrs)
+        {
+            parent = get_copy_of(parent);
+        }
+        OpSet child_ptrs;
+        for (const auto &child : operation->child_ptrs)
+        {
+            child_ptrs.insert(get_copy_of(child));
+        }
+        operation->child_ptrs = child_ptrs;
+        OpSet bootstrap_children;
+        for (const auto &child : operation->bootstrap_children)
+        {
+            bootstrap_children.insert(get_copy_of(child));
+        }
+        operation->bootstrap_children = bootstrap_children;
+    }
+
+    for (auto &segment : bootstrap_segments)
+    {
+        segment.remap_operations([this](const OperationPtr &operation)
+                                 { return get_copy_of(operation); });
+    }
+
+    for (const auto &[operation, segment_indexes] : other.segment_indexes_started_by_op)
+    {
+        segment_indexes_started_by_op[get_copy_of(operation)] = segment_indexes;
+    }
+}
+
+Program &Program::operator=(const Program &other)
+{
+    return *this = Program(other);
+}
+
+// Operation ids match positions, so the operation with the same id in this
+// program is the copy of an operation from the program this was copied from.
+OperationPtr Program::get_copy_of(const OperationPtr &operation) const
+{
+    if (operation == nullptr)
+    {
+        return nullptr;
+    }
+    return operations[operation->id - 1];
 }
 
 OpVector::const_iterator Program::begin() const { return operations.begin(); };
@@ -38,8 +101,47 @@ int Program::get_latency_of(const OperationType::Type type) const
     return latencies.at(type);
 };
 
+int Program::get_latency_of(const OperationPtr &operation) const
+{
+    return operation->get_latency(latencies);
+}
+
+int Program::get_bootstrap_latency_of(const OperationPtr &operation) const
+{
+    return operation->get_bootstrap_latency(latencies);
+}
+
+const LatencyMap &Program::get_latencies() const
+{
+    return latencies;
+}
+
+// Fresh inputs and bootstrapped results have every level of the latency
+// file left. Levels are only tracked when the latencies depend on them.
+void Program::update_operation_levels()
+{
+    if (!latencies.is_level_resolved())
+    {
+        return;
+    }
+
+    auto max_level = latencies.get_max_level();
+    for (auto operation : operations)
+    {
+        operation->level = max_level;
+        for (const auto &parent : operation->parent_ptrs)
+        {
+            if (!operation->receives_bootstrapped_result_from(parent))
+            {
+                operation->level = std::min(operation->level, parent->get_result_level());
+            }
+        }
+    }
+}
+
 void Program::update_slack_for_every_operation()
 {
+    update_operation_levels();
     int earliest_program_finish_time = 0;
     for (auto operation : operations)
     {
@@ -92,7 +194,78 @@ void Program::reset_bootstrap_set()
     for (auto operation : operations)
     {
         operation->bootstrap_children.clear();
+        operation->num_unsatisfied_segments = 0;
+    }
+
+    for (auto &segment : bootstrap_segments)
+    {
+        segment.update_satisfied_status(mode);
     }
+
+    unsatisfied_bootstrap_segment_indexes.clear();
+    alive_bootstrap_segment_indexes.clear();
+    segment_indexes_started_by_op.clear();
+}
+
+size_t Program::get_num_bootstrapped_operations() const
+{
+    return std::ranges::count_if(operations, [](const OperationPtr &operation)
+                                 { return operation->is_bootstrapped(); });
+}
+
+// Un-bootstraps every operation whose segments are all satisfied by some
+// other bootstrapped operation. Operations on few segments are tried first.
+size_t Program::remove_redundant_bootstrapped_operations()
+{
+    std::vector<int> num_bootstrapped_ops_of_segment(bootstrap_segments.size());
+    std::unordered_map<OperationPtr, std::vector<size_t>> segment_indexes_of_op;
+    for (size_t i = 0; i < bootstrap_segments.size(); i++)
+    {
+        for (const auto &operation : bootstrap_segments[i])
+        {
+            if (operation->is_bootstrapped())
+            {
+                num_bootstrapped_ops_of_segment[i]++;
+                segment_indexes_of_op[operation].push_back(i);
+            }
+        }
+    }
+
+    OpVector bootstrapped_operations;
+    for (const auto &[operation, _] : segment_indexes_of_op)
+    {
+        bootstrapped_operations.push_back(operation);
+    }
+    std::ranges::sort(bootstrapped_operations, [&segment_indexes_of_op](const OperationPtr &a, const OperationPtr &b)
+                      {
+        auto a_num_segments = segment_indexes_of_op[a].size();
+        auto b_num_segments = segment_indexes_of_op[b].size();
+        if (a_num_segments == b_num_segments)
+        {
+            return a->id < b->id;
+        }
+        return a_num_segments < b_num_segments; });
+
+    size_t num_removed = 0;
+    for (const auto &operation : bootstrapped_operations)
+    {
+        const auto &segment_indexes = segment_indexes_of_op[operation];
+        auto is_redundant = std::ranges::all_of(
+            segment_indexes,
+            [&num_bootstrapped_ops_of_segment](const size_t i)
+            { return num_bootstrapped_ops_of_segment[i] > 1; });
+
+        if (is_redundant)
+        {
+            operation->bootstrap_children.clear();
+            for (const auto i : segment_indexes)
+            {
+                num_bootstrapped_ops_of_segment[i]--;
+            }
+            num_removed++;
+        }
+    }
+    return num_removed;
 }
 
 bool Program::has_unsatisfied_bootstrap_segments() const
@@ -224,16 +397,26 @@ void Program::update_alive_segments(const OperationPtr &bootstrapped_op, const s
     }
 }
 
-void Program::remove_unnecessary_bootstrap_pairs(size_t &num_removed, size_t &total_num_pairs)
+void Program::remove_unnecessary_bootstrap_pairs(size_t &num_removed, size_t &total_num_pairs, const utl::TimeBudget &time_budget, utl::QualityLog &quality_log)
 {
-    auto pairs_to_indexes_map = get_candidate_pairs_and_segment_indexes(total_num_pairs);
+    auto pair_index = get_bootstrap_pair_index();
+    total_num_pairs = pair_index.pairs.size();
+
+    auto candidates = get_pair_removal_candidates(pair_index);
+    auto removable = get_removable_pair_flags(pair_index, candidates);
+    quality_log.record(total_num_pairs - std::ranges::count(removable, 1));
+
+    if (time_budget.is_limited())
+    {
+        search_for_better_pair_removal_order(pair_index, candidates, removable, time_budget, quality_log);
+    }
 
     num_removed = 0;
-    for (const auto &[candidate_pair, segment_indexes] : pairs_to_indexes_map)
+    for (size_t slot = 0; slot < total_num_pairs; slot++)
     {
-        if (no_segment_relies_on_bootstrap_pair(candidate_pair, segment_indexes))
+        if (removable[slot])
         {
-            auto &[parent, child] = candidate_pair;
+            auto &[parent, child] = pair_index.pairs[slot];
             parent->bootstrap_children.erase(child);
             num_removed++;
         }
@@ -241,47 +424,159 @@ void Program::remove_unnecessary_bootstrap_pairs(size_t &num_removed, size_t &to
     std::cout << "Removed " << num_removed << " unnecessary bootstrapped results." << std::endl;
 }
 
-BootstrapPairIndexesMap Program::get_candidate_pairs_and_segment_indexes(size_t &total_num_pairs)
+// Slots are assigned in (parent id, child id) order, which is the order
+// the greedy removal visits the pairs in.
+Program::BootstrapPairIndex Program::get_bootstrap_pair_index() const
 {
-    BootstrapPairIndexesMap candidate_pairs_map;
-    BootstrapPairSet needed_pairs;
+    const auto num_segments = bootstrap_segments.size();
+    std::vector<BootstrapPairVector> satisfying_pairs(num_segments);
 
-    for (size_t i = 0; i < bootstrap_segments.size(); i++)
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_t i = 0; i < num_segments; i++)
+    {
+        satisfying_pairs[i] = bootstrap_segments[i].get_currently_satisfying_pairs();
+    }
+
+    BootstrapPairIndex index;
+    for (const auto &pairs : satisfying_pairs)
     {
-        auto satisfying_pairs = bootstrap_segments[i].get_currently_satisfying_pairs();
+        index.pairs.insert(index.pairs.end(), pairs.begin(), pairs.end());
+    }
+    std::sort(index.pairs.begin(), index.pairs.end());
+    index.pairs.erase(std::unique(index.pairs.begin(), index.pairs.end()), index.pairs.end());
+
+    index.pair_slots_of_segment.resize(num_segments);
+    index.segment_indexes_of_pair.resize(index.pairs.size());
 
-        if (satisfying_pairs.size() > 1)
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_t i = 0; i < num_segments; i++)
+    {
+        auto &slots = index.pair_slots_of_segment[i];
+        for (const auto &pair : satisfying_pairs[i])
         {
-            for (auto &pair : satisfying_pairs)
-            {
-                candidate_pairs_map[pair].insert(i);
-            }
+            auto it = std::lower_bound(index.pairs.begin(), index.pairs.end(), pair);
+            slots.push_back(it - index.pairs.begin());
         }
-        else
+    }
+
+    for (size_t i = 0; i < num_segments; i++)
+    {
+        for (const auto slot : index.pair_slots_of_segment[i])
         {
-            needed_pairs.insert(satisfying_pairs.begin(), satisfying_pairs.end());
+            index.segment_indexes_of_pair[slot].push_back(i);
         }
     }
 
-    for (const auto &pair : needed_pairs)
+    return index;
+}
+
+// A pair may be removed when every segment it satisfies is still satisfied
+// by at least one other pair. Pairs on a segment with a single satisfying
+// pair are needed. Candidates that share no segment with another candidate
+// cannot affect each other, so they are decided here in parallel. The rest
+// are returned in slot order to be decided greedily.
+Program::PairRemovalCandidates Program::get_pair_removal_candidates(const BootstrapPairIndex &index) const
+{
+    const auto num_pairs = index.pairs.size();
+    const auto num_segments = index.pair_slots_of_segment.size();
+
+    std::vector<char> is_candidate(num_pairs);
+#pragma omp parallel for
+    for (size_t slot = 0; slot < num_pairs; slot++)
     {
-        candidate_pairs_map.erase(pair);
+        is_candidate[slot] = std::ranges::all_of(
+            index.segment_indexes_of_pair[slot],
+            [&index](const size_t i)
+            { return index.pair_slots_of_segment[i].size() > 1; });
     }
 
-    total_num_pairs = candidate_pairs_map.size() + needed_pairs.size();
+    std::vector<int> num_candidates(num_segments);
+#pragma omp parallel for
+    for (size_t i = 0; i < num_segments; i++)
+    {
+        num_candidates[i] = std::ranges::count_if(
+            index.pair_slots_of_segment[i],
+            [&is_candidate](const size_t slot)
+            { return is_candidate[slot]; });
+    }
 
-    return candidate_pairs_map;
+    PairRemovalCandidates candidates;
+    candidates.independent_removals.resize(num_pairs);
+#pragma omp parallel for
+    for (size_t slot = 0; slot < num_pairs; slot++)
+    {
+        candidates.independent_removals[slot] =
+            is_candidate[slot] &&
+            std::ranges::all_of(
+                index.segment_indexes_of_pair[slot],
+                [&num_candidates](const size_t i)
+                { return num_candidates[i] == 1; });
+    }
+
+    for (size_t slot = 0; slot < num_pairs; slot++)
+    {
+        if (is_candidate[slot] && !candidates.independent_removals[slot])
+        {
+            candidates.dependent_slots.push_back(slot);
+        }
+    }
+
+    return candidates;
 }
 
-bool Program::no_segment_relies_on_bootstrap_pair(const BootstrapPair &pair, const std::unordered_set<size_t> &segment_indexes)
+std::vector<char> Program::get_removable_pair_flags(const BootstrapPairIndex &index, const PairRemovalCandidates &candidates) const
 {
-    const auto &[parent, child] = pair;
-    for (const auto i : segment_indexes)
+    const auto num_segments = index.pair_slots_of_segment.size();
+
+    std::vector<int> num_satisfying_pairs(num_segments);
+    for (size_t i = 0; i < num_segments; i++)
     {
-        if (bootstrap_segments[i].relies_on_bootstrap_pair(parent, child))
+        num_satisfying_pairs[i] = index.pair_slots_of_segment[i].size();
+    }
+
+    auto removable = candidates.independent_removals;
+    for (const auto slot : candidates.dependent_slots)
+    {
+        const auto &segment_indexes = index.segment_indexes_of_pair[slot];
+        removable[slot] = std::ranges::all_of(
+            segment_indexes,
+            [&num_satisfying_pairs](const size_t i)
+            { return num_satisfying_pairs[i] > 1; });
+
+        if (removable[slot])
+        {
+            for (const auto i : segment_indexes)
+            {
+                num_satisfying_pairs[i]--;
+            }
+        }
+    }
+
+    return removable;
+}
+
+// Anytime improvement: the greedy result depends on the order in which
+// dependent candidates are visited. Pairs on few segments are tried first,
+// then random orders, until the time budget expires.
+void Program::search_for_better_pair_removal_order(const BootstrapPairIndex &index, PairRemovalCandidates &candidates, std::vector<char> &best_removable, const utl::TimeBudget &time_budget, utl::QualityLog &quality_log) const
+{
+    auto best_num_removed = std::ranges::count(best_removable, 1);
+
+    std::ranges::stable_sort(candidates.dependent_slots, [&index](const size_t a, const size_t b)
+                             { return index.segment_indexes_of_pair[a].size() < index.segment_indexes_of_pair[b].size(); });
+
+    std::minstd_rand rand_gen;
+    while (!time_budget.expired() && !candidates.dependent_slots.empty())
+    {
+        auto removable = get_removable_pair_flags(index, candidates);
+        auto num_removed = std::ranges::count(removable, 1);
+        if (num_removed > best_num_removed)
         {
-            return false;
+            best_num_removed = num_removed;
+            best_removable = std::move(removable);
+            quality_log.record(index.pairs.size() - best_num_removed);
         }
+
+        std::shuffle(candidates.dependent_slots.begin(), candidates.dependent_slots.end(), rand_gen);
     }
-    return true;
 }
\ No newline at end of file
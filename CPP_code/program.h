@@ -20,6 +20,11 @@ public:
 
     Program(){};
     Program(const ConstructorInput &);
+    // Copies are deep, so a copy can be scheduled independently.
+    Program(const Program &);
+    Program &operator=(const Program &);
+    Program(Program &&) = default;
+    Program &operator=(Program &&) = default;
 
     OpVector::const_iterator begin() const;
     OpVector::const_iterator end() const;
@@ -27,6 +32,9 @@ public:
 
     OperationPtr get_operation_ptr_from_id(const size_t) const;
     int get_latency_of(const OperationType::Type) const;
+    int get_latency_of(const OperationPtr &) const;
+    int get_bootstrap_latency_of(const OperationPtr &) const;
+    const LatencyMap &get_latencies() const;
     int get_maximum_slack() const;
     int get_maximum_num_segments() const;
     bool has_unsatisfied_bootstrap_segments() const;
@@ -41,11 +49,14 @@ public:
     void set_bootstrap_segments(const std::vector<BootstrapSegment> &);
     void set_boot_mode(const BootstrapMode);
 
+    void update_operation_levels();
     void update_slack_for_every_operation();
     void reset_bootstrap_set();
     void update_all_bootstrap_urgencies();
+    size_t get_num_bootstrapped_operations() const;
+    size_t remove_redundant_bootstrapped_operations();
 
-    void remove_unnecessary_bootstrap_pairs(size_t &, size_t &);
+    void remove_unnecessary_bootstrap_pairs(size_t &, size_t &, const utl::TimeBudget &, utl::QualityLog &);
 
 private:
     OpVector operations;
@@ -59,9 +70,27 @@ private:
          {OperationType::SUB, 1},
          {OperationType::MUL, 5},
          {OperationType::BOOT, 300}};
-    BootstrapPairIndexesMap get_candidate_pairs_and_segment_indexes(size_t &);
     BootstrapMode mode = BootstrapMode::COMPLETE;
-    bool no_segment_relies_on_bootstrap_pair(const BootstrapPair &, const std::unordered_set<size_t> &);
+
+    struct BootstrapPairIndex
+    {
+        BootstrapPairVector pairs;
+        std::vector<std::vector<size_t>> pair_slots_of_segment;
+        std::vector<std::vector<size_t>> segment_indexes_of_pair;
+    };
+
+    struct PairRemovalCandidates
+    {
+        std::vector<char> independent_removals;
+        std::vector<size_t> dependent_slots;
+    };
+
+    OperationPtr get_copy_of(const OperationPtr &) const;
+
+    BootstrapPairIndex get_bootstrap_pair_index() const;
+    PairRemovalCandidates get_pair_removal_candidates(const BootstrapPairIndex &) const;
+    std::vector<char> get_removable_pair_flags(const BootstrapPairIndex &, const PairRemovalCandidates &) const;
+    void search_for_better_pair_removal_order(const BootstrapPairIndex &, PairRemovalCandidates &, std::vector<char> &, const utl::TimeBudget &, utl::QualityLog &) const;
 
     class FileParser;
     friend class FileWriter;
@@ -75,34 +75,32 @@ bool utl::arg_exists(const std::string &options_string, const std::string &short
 
 std::string utl::get_arg(const std::string &options_string, const std::string &short_form, const std::string &long_form, const std::string &help_info)
 {
-    auto short_pos = options_string.find(short_form);
-    auto long_pos = options_string.find(long_form);
+    auto short_pos = options_string.find(" " + short_form + " ");
+    auto long_pos = options_string.find(" " + long_form + "=");
     size_t start_pos;
-    char expected_char;
     if (short_pos != std::string::npos)
     {
-        start_pos = short_pos + short_form.size() + 1;
-        expected_char = ' ';
+        start_pos = short_pos + short_form.size() + 2;
     }
     else if (long_pos != std::string::npos)
     {
-        start_pos = long_pos + long_form.size() + 1;
-        expected_char = '=';
+        start_pos = long_pos + long_form.size() + 2;
     }
     else
     {
+        auto misformatted = options_string.find(" " + short_form + "=") != std::string::npos ||
+                            options_string.find(" " + long_form + " ") != std::string::npos;
+        if (misformatted)
+        {
+            std::cout << "Options must follow the format shown." << std::endl;
+            std::cout << help_info << std::endl;
+            exit(-1);
+        }
         return "";
     }
 
-    if (options_string.at(start_pos - 1) != expected_char)
-    {
-        std::cout << "Options must follow the format shown." << std::endl;
-        std::cout << help_info << std::endl;
-        exit(-1);
-    }
-
-    auto end_pos = options_string.substr(start_pos, options_string.size() - start_pos).find(" ");
-    return options_string.substr(start_pos, end_pos);
+    auto end_pos = options_string.find(" ", start_pos);
+    return options_string.substr(start_pos, end_pos - start_pos);
 }
 
 bool utl::bool_arg_converter(const std::string &arg_val)
@@ -138,4 +136,57 @@ double utl::get_percent_error(const double experimental, const double expected)
         // return std::abs(experimental) < 0.000000001;
     }
     return std::abs(experimental - expected) / expected * 100;
+}
+
+utl::TimeBudget::TimeBudget() : TimeBudget(-1) {}
+
+utl::TimeBudget::TimeBudget(const double budget_seconds)
+    : start_time{Clock::now()}, budget_seconds{budget_seconds} {}
+
+bool utl::TimeBudget::is_limited() const
+{
+    return budget_seconds >= 0;
+}
+
+bool utl::TimeBudget::expired() const
+{
+    return is_limited() && elapsed_seconds() >= budget_seconds;
+}
+
+double utl::TimeBudget::elapsed_seconds() const
+{
+    return std::chrono::duration<double>(Clock::now() - start_time).count();
+}
+
+double utl::TimeBudget::remaining_seconds() const
+{
+    return std::max(0.0, budget_seconds - elapsed_seconds());
+}
+
+utl::QualityLog::QualityLog(const TimeBudget &time_budget)
+    : time_budget_ref{time_budget} {}
+
+void utl::QualityLog::record(const double quality)
+{
+    entries.emplace_back(time_budget_ref.get().elapsed_seconds(), quality);
+}
+
+void utl::QualityLog::write_to_file(const std::string &filename) const
+{
+    std::ofstream file(filename);
+    file << "time,quality" << std::endl;
+    for (const auto &[time, quality] : entries)
+    {
+        file << time << "," << quality << std::endl;
+    }
+}
+
+utl::TimeBudget utl::get_time_budget_arg(const std::string &options_string, const std::string &help_info)
+{
+    auto time_budget_string = get_arg(options_string, "-T", "--time-budget", help_info);
+    if (time_budget_string.empty())
+    {
+        return TimeBudget();
+    }
+    return TimeBudget(std::stod(time_budget_string));
 }
\ No newline at end of file
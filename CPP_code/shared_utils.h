@@ -41,6 +41,39 @@ namespace utl
     int random_int_between(const int, const int, std::minstd_rand &);
     double get_percent_error(const double, const double);
 
+    class TimeBudget
+    {
+    public:
+        TimeBudget();
+        TimeBudget(const double);
+
+        bool is_limited() const;
+        bool expired() const;
+        double elapsed_seconds() const;
+        double remaining_seconds() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        Clock::time_point start_time;
+        double budget_seconds;
+    };
+
+    class QualityLog
+    {
+    public:
+        QualityLog(const TimeBudget &);
+
+        void record(const double);
+        void write_to_file(const std::string &) const;
+
+    private:
+        std::reference_wrapper<const TimeBudget> time_budget_ref;
+        std::vector<std::pair<double, double>> entries;
+    };
+
+    TimeBudget get_time_budget_arg(const std::string &, const std::string &);
+
     template <typename T, typename S>
     void remove_key_subset_from_map(std::map<T, S> &map, const std::unordered_set<T> key_subset)
     {
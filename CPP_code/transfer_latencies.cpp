@@ -0,0 +1,61 @@
+#include "transfer_latencies.h"
+
+TransferLatencies::TransferLatencies(const std::string &filename, int num_cores)
+{
+    parse_matrix_file(filename);
+
+    const int num_rows = matrix.size();
+    if (num_rows == 0 || num_cores % num_rows != 0)
+    {
+        std::cout << "The transfer latency matrix in " << filename << " has " << num_rows
+                  << " rows, which does not divide the " << num_cores << " cores." << std::endl;
+        exit(1);
+    }
+    cores_per_row = num_cores / num_rows;
+}
+
+void TransferLatencies::parse_matrix_file(const std::string &filename)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        std::cout << "Could not open transfer latency file " << filename << std::endl;
+        exit(1);
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        utl::trim(line);
+        if (line.empty())
+        {
+            continue;
+        }
+
+        std::vector<int> row;
+        for (const auto &value : utl::split_string_by_character(line, ','))
+        {
+            row.push_back(std::stoi(value));
+        }
+        matrix.push_back(row);
+    }
+
+    for (const auto &row : matrix)
+    {
+        if (row.size() != matrix.size())
+        {
+            std::cout << "The transfer latency matrix in " << filename << " is not square." << std::endl;
+            exit(1);
+        }
+    }
+}
+
+// Cores are numbered from 1.
+int TransferLatencies::get_latency(int source_core, int destination_core) const
+{
+    if (matrix.empty())
+    {
+        return 0;
+    }
+    return matrix[(source_core - 1) / cores_per_row][(destination_core - 1) / cores_per_row];
+}
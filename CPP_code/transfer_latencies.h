@@ -0,0 +1,28 @@
+#ifndef transfer_latencies_INCLUDED_
+#define transfer_latencies_INCLUDED_
+
+#include "shared_utils.h"
+
+// The cycles needed to move a ciphertext from one core to another.
+//
+// The file is a square matrix of comma separated values, where row i,
+// column j is the cost of moving a value from core i to core j. A matrix
+// smaller than the number of cores is read as socket-level, with cores
+// split into equally sized, consecutive sockets. Without a file, every
+// transfer is free.
+class TransferLatencies
+{
+public:
+    TransferLatencies(){};
+    TransferLatencies(const std::string &, int);
+
+    int get_latency(int, int) const;
+
+private:
+    std::vector<std::vector<int>> matrix;
+    int cores_per_row = 1;
+
+    void parse_matrix_file(const std::string &);
+};
+
+#endif
@@ -1,6 +1,9 @@
 #!/bin/bash
 
-#Usage <script_name> <first_graph_num> <last_graph_num> <heuristic_name> <sched_name> <num_cores> <bootstrap_levels> <initial_levels> <engine_options>
+#Usage <script_name> <first_graph_num> <last_graph_num> <heuristic_name> <sched_name> <num_cores> <bootstrap_levels> <initial_levels> <inputs> <engine_options> [<key_cache_dir>]
+
+# Every run with the same parameters reuses the crypto context and keys
+# stored in key_cache_dir, which defaults to ./results/key_cache.
 
 first_graph_num=$1
 last_graph_num=$2
@@ -11,6 +14,7 @@ bootstrap_levels=$6
 initial_levels=$7
 inputs=$8
 engine_options=$9
+key_cache_dir=${10:-./results/key_cache}
 
 make -C ./CPP_code/execution_engine/build
 
@@ -25,6 +29,6 @@ do
     
     sched_file=./results/random_graph$i/b${bootstrap_levels}_i${initial_levels}/${heuristic_name}/${num_cores}_cores/rg${i}_${sched_name}
     
-    echo ./CPP_code/execution_engine/build/execution_engine $sched_file -l $bootstrap_levels $inputs_argument $engine_options
-    ./CPP_code/execution_engine/build/execution_engine $sched_file -l $bootstrap_levels $inputs_argument $engine_options
+    echo ./CPP_code/execution_engine/build/execution_engine $sched_file -l $bootstrap_levels -k $key_cache_dir $inputs_argument $engine_options
+    ./CPP_code/execution_engine/build/execution_engine $sched_file -l $bootstrap_levels -k $key_cache_dir $inputs_argument $engine_options
 done
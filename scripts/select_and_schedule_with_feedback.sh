@@ -0,0 +1,80 @@
+#!/bin/bash
+
+#Usage <script_name> <first_graph_num> <last_graph_num> <levels> <segments_weight> <slack_weight> <urgency_weight> <num_cores> <max_iterations> [<time_budget_seconds>]
+
+# Alternates bootstrap set selection and list scheduling. Every selection
+# after the first scores slack with the previous schedule (-f), and the
+# loop stops once the makespan stops improving, after max_iterations, or
+# when the time budget is used up. The best schedule is copied to
+# best_schedule.* and the makespan of every iteration is written to
+# feedback.csv.
+
+make bootstrap_set_selector.out complete_to_selective_converter.out list_scheduler.out
+
+first_graph_num=$1
+last_graph_num=$2
+levels=$3
+segments_weight=$4
+slack_weight=$5
+urgency_weight=$6
+num_cores=$7
+max_iterations=$8
+time_budget_seconds=${9:-0}
+
+get_makespan() {
+    head -n 1 "$1.lgr" | sed -e 's/Objective value: //' -e 's/\..*//'
+}
+
+for i in $(seq $first_graph_num $last_graph_num)
+do
+    dag_file="DAGs/random_graph$i/random_graph$i.txt"
+    standard_segments_file="DAGs/random_graph$i/$levels/bootstrap_segments_standard.dat"
+    selective_segments_file="DAGs/random_graph$i/$levels/bootstrap_segments_selective.dat"
+
+    result_dir="results/random_graph$i"
+    mkdir $result_dir
+    result_dir="$result_dir/$levels"
+    mkdir $result_dir
+    result_dir="$result_dir/feedback_s${segments_weight}_r${slack_weight}_u${urgency_weight}"
+    mkdir $result_dir
+    result_dir="$result_dir/${num_cores}_cores"
+    mkdir $result_dir
+
+    echo "iteration,makespan" > $result_dir/feedback.csv
+
+    SECONDS=0
+    feedback_option=""
+    best_makespan=""
+    for iteration in $(seq 1 $max_iterations)
+    do
+        set_file="$result_dir/complete_bootstrap_set_$iteration"
+        converted_set_file="$result_dir/converted_bootstrap_set_$iteration.lgr"
+        schedule_file="$result_dir/schedule_$iteration"
+
+        echo ./CPP_code/bootstrap_set_selector.out $dag_file $standard_segments_file $set_file $levels -s $segments_weight -r $slack_weight -u $urgency_weight $feedback_option
+        ./CPP_code/bootstrap_set_selector.out $dag_file $standard_segments_file $set_file $levels -s $segments_weight -r $slack_weight -u $urgency_weight $feedback_option
+        ./CPP_code/complete_to_selective_converter.out $dag_file $selective_segments_file $set_file.lgr $converted_set_file
+        ./CPP_code/list_scheduler.out $dag_file $schedule_file -i $converted_set_file -t $num_cores
+
+        makespan=$(get_makespan $schedule_file)
+        echo "$iteration,$makespan" >> $result_dir/feedback.csv
+
+        if [[ -z "$best_makespan" || $makespan -lt $best_makespan ]]; then
+            best_makespan=$makespan
+            for extension in lgr sched log
+            do
+                cp $schedule_file.$extension $result_dir/best_schedule.$extension
+            done
+        elif [[ $iteration -gt 1 ]]; then
+            break
+        fi
+
+        if [[ $time_budget_seconds -gt 0 && $SECONDS -ge $time_budget_seconds ]]; then
+            break
+        fi
+
+        feedback_option="-f $schedule_file.lgr"
+    done
+
+    echo "random_graph$i best makespan: $best_makespan"
+done